@@ -4,20 +4,63 @@ greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
 CONFIG += c++17
 
+# Встроенное профилирование (таймеры стадий, счётчики, Chrome Trace):
+# qmake CONFIG+=profiling
+profiling: DEFINES += TPL_PROFILING
+
 # You can make your code fail to compile if it uses deprecated APIs.
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    ambiguity.cpp \
+    arena.cpp \
+    batchchecker.cpp \
+    chaincache.cpp \
+    chaincounter.cpp \
+    chaingenerator.cpp \
+    chainmodal.cpp \
     chaintreedialog.cpp \
+    cli.cpp \
+    cykparser.cpp \
+    cykrecognizer.cpp \
+    dfa.cpp \
+    indexedgrammar.cpp \
+    lrtable.cpp \
     main.cpp \
-    mainwindow.cpp
+    mainwindow.cpp \
+    parallelcyk.cpp \
+    productgrammar.cpp \
+    profiler.cpp \
+    resultcache.cpp \
+    shortestwords.cpp \
+    worditerator.cpp
 
 HEADERS += \
+    ambiguity.h \
+    arena.h \
+    batchchecker.h \
+    chaincache.h \
+    chaincounter.h \
+    chaingenerator.h \
+    chainmodal.h \
     chaintreedialog.h \
-    mainwindow.h
+    cli.h \
+    cykparser.h \
+    cykrecognizer.h \
+    dfa.h \
+    indexedgrammar.h \
+    lrtable.h \
+    mainwindow.h \
+    parallelcyk.h \
+    productgrammar.h \
+    profiler.h \
+    resultcache.h \
+    shortestwords.h \
+    worditerator.h
 
 FORMS += \
+    chainmodal.ui \
     chaintreedialog.ui \
     mainwindow.ui
 
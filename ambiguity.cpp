@@ -0,0 +1,309 @@
+#include "ambiguity.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+static const int kInfinity = std::numeric_limits<int>::max();
+static const qint64 kWitnessBudget = 1000000;
+static const qint64 kWordsBudget = 200000;
+static const quint64 kLoopTreeSearch = 4096;
+static const qint64 kProgressStep = 64;
+
+// Повторяет петлю A -> A в вершине A[from, to), если она есть в дереве.
+static bool repeatLoop(CykParser::Tree& tree, int nonterminal, int from, int to)
+{
+    const CykParser::Child& node = tree.node;
+    if (!node.terminal && node.symbol == nonterminal && node.from == from && node.to == to) {
+        CykParser::Tree inner = tree;
+        tree.children.clear();
+        tree.children.push_back(std::move(inner));
+        return true;
+    }
+    for (CykParser::Tree& child : tree.children)
+        if (repeatLoop(child, nonterminal, from, to))
+            return true;
+    return false;
+}
+
+AmbiguityAnalyzer::AmbiguityAnalyzer(const Grammars::IndexedGrammar &grammar, int maxLength)
+    : g(grammar)
+    , counter(grammar, maxLength)
+    , shortest(grammar)
+    , parser(grammar)
+    , limit(maxLength)
+{
+    computeShortest();
+    computeContexts();
+
+    looping = QList<bool>(g.nonterminals.size(), false);
+    for (int a : g.selfLoops)
+        if (context[a] != kInfinity && minLength[a] != kInfinity)
+            looping[a] = hasLoops = true;
+}
+
+AmbiguityReport AmbiguityAnalyzer::analyze(int wordLimit)
+{
+    AmbiguityReport report;
+    for (int length = 0; length <= limit; ++length)
+        report.derivationsPerLength.append(counter.nonterminalCount(g.start, length));
+    report.infinite = hasLoops;
+
+    budget = kWitnessBudget;
+    exhausted = false;
+    canceled = false;
+    for (int total = 1; total <= limit && !report.ambiguous && !canceled; ++total) {
+        permille = 900 * (total - 1) / limit;
+        for (int a = 0; a < g.nonterminals.size(); ++a) {
+            if (context[a] == kInfinity || minLength[a] == kInfinity || total - context[a] < 1)
+                continue;
+            QList<int> local;
+            bool loop = looping[a] && minLength[a] == total - context[a];
+            if (loop)
+                shortest.appendWord(a, local);
+            else if (!findLocal(a, total - context[a], local))
+                continue;
+
+            QList<int> left, right;
+            contextWords(a, left, right);
+            QList<int> word = left + local + right;
+
+            parser.parse(word);
+            report.ambiguous = true;
+            report.witness = g.fromTerminals(word);
+            if (!loop) {
+                report.firstTree = treeToString(parser, parser.derivation(0, 0, word.size(), g.start));
+                report.secondTree = treeToString(parser, parser.derivation(1, 0, word.size(), g.start));
+                break;
+            }
+
+            // Второй вывод — первый с ещё одним применением петли в A. Если
+            // среди первых выводов цепочки A на нужном отрезке не нашлось,
+            // показываются поддеревья самого A.
+            const int from = left.size(), to = from + local.size();
+            CykParser::Tree first = parser.derivation(0, from, to, a);
+            CykParser::Tree second = first;
+            bool found = false;
+            quint64 trees = std::min(parser.derivations(), kLoopTreeSearch);
+            for (quint64 index = 0; index < trees && !found; ++index) {
+                CykParser::Tree tree = parser.derivation(index, 0, word.size(), g.start);
+                CykParser::Tree looped = tree;
+                if ((found = repeatLoop(looped, a, from, to))) {
+                    first = std::move(tree);
+                    second = std::move(looped);
+                }
+            }
+            if (!found)
+                repeatLoop(second, a, from, to);
+            report.firstTree = treeToString(parser, first);
+            report.secondTree = treeToString(parser, second);
+            break;
+        }
+    }
+    bool witnessComplete = !exhausted;
+
+    if (report.ambiguous && !canceled) {
+        permille = 900;
+        budget = kWordsBudget;
+        exhausted = false;
+        QList<int> prefix;
+        collectAmbiguous(prefix, wordLimit, report.ambiguousWords);
+    }
+    report.complete = witnessComplete && !exhausted;
+    return report;
+}
+
+QString AmbiguityAnalyzer::treeToString(const CykParser &parser, const CykParser::Tree &tree)
+{
+    QString result = parser.symbolName(tree.node);
+    if (tree.node.terminal)
+        return result;
+    QStringList children;
+    for (const auto& child : tree.children)
+        children.append(treeToString(parser, child));
+    return result + "(" + children.join(" ") + ")";
+}
+
+void AmbiguityAnalyzer::computeShortest()
+{
+    minLength = QList<int>(g.nonterminals.size(), kInfinity);
+    for (int a = 0; a < g.nonterminals.size(); ++a)
+        if (shortest.length(a) >= 0)
+            minLength[a] = shortest.length(a);
+}
+
+void AmbiguityAnalyzer::computeContexts()
+{
+    // context[A] — наименьшая суммарная длина x и y в выводе S =>* xAy.
+    context = QList<int>(g.nonterminals.size(), kInfinity);
+    contextRule = QList<int>(g.nonterminals.size(), -1);
+    context[g.start] = 0;
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int i = 0; i < g.binary.size(); ++i) {
+            const auto& rule = g.binary[i];
+            if (context[rule.lhs] == kInfinity)
+                continue;
+            if (minLength[rule.right] != kInfinity && context[rule.lhs] + minLength[rule.right] < context[rule.left]) {
+                context[rule.left] = context[rule.lhs] + minLength[rule.right];
+                contextRule[rule.left] = 2 * i;
+                changed = true;
+            }
+            if (minLength[rule.left] != kInfinity && context[rule.lhs] + minLength[rule.left] < context[rule.right]) {
+                context[rule.right] = context[rule.lhs] + minLength[rule.left];
+                contextRule[rule.right] = 2 * i + 1;
+                changed = true;
+            }
+        }
+    }
+}
+
+void AmbiguityAnalyzer::contextWords(int nonterminal, QList<int> &left, QList<int> &right) const
+{
+    int current = nonterminal;
+    while (current != g.start) {
+        const auto& rule = g.binary[contextRule[current] / 2];
+        QList<int> sibling;
+        if (contextRule[current] % 2 == 0) {
+            shortest.appendWord(rule.right, sibling);
+            right.append(sibling);
+        } else {
+            shortest.appendWord(rule.left, sibling);
+            left = sibling + left;
+        }
+        current = rule.lhs;
+    }
+}
+
+QList<AmbiguityAnalyzer::Choice> AmbiguityAnalyzer::choices(int nonterminal, int length) const
+{
+    QList<Choice> result;
+    if (length == 1) {
+        for (int index : g.unaryByLhs[nonterminal])
+            result.append({-1, -1, -1, g.unary[index].terminal});
+        return result;
+    }
+    for (int index : g.binaryByLhs[nonterminal]) {
+        const auto& rule = g.binary[index];
+        for (int split = 1; split < length; ++split)
+            if (counter.nonterminalCount(rule.left, split) > 0 && counter.nonterminalCount(rule.right, length - split) > 0)
+                result.append({rule.left, rule.right, split, -1});
+    }
+    return result;
+}
+
+quint64 AmbiguityAnalyzer::weight(const Choice &choice, const QList<int> &prefix, int length)
+{
+    if (choice.terminal >= 0)
+        return prefix.isEmpty() || prefix[0] == choice.terminal ? 1 : 0;
+    quint64 left = counter.overlapCount(prefix, 0, choice.split, choice.left);
+    if (left == 0)
+        return 0;
+    return saturatingMul(left, counter.overlapCount(prefix, choice.split, length - choice.split, choice.right));
+}
+
+bool AmbiguityAnalyzer::spend()
+{
+    if (--budget < 0 || canceled) {
+        exhausted = true;
+        return false;
+    }
+    if (progress && budget % kProgressStep == 0 && !progress(permille)) {
+        canceled = exhausted = true;
+        return false;
+    }
+    return true;
+}
+
+bool AmbiguityAnalyzer::findLocal(int nonterminal, int length, QList<int> &word)
+{
+    QList<Choice> initial = choices(nonterminal, length);
+    if (initial.size() < 2)
+        return false;
+    word.clear();
+    return search(initial, length, word);
+}
+
+bool AmbiguityAnalyzer::throughLoop(const QList<int> &word)
+{
+    // Обход сверху вниз по вершинам A[from, to), входящим хотя бы в один
+    // вывод цепочки.
+    if (!parser.parse(word))
+        return false;
+    const int n = word.size();
+    const int symbols = g.nonterminals.size();
+    auto slot = [&](int a, int from, int to) { return (size_t(from) * (n + 1) + to) * symbols + a; };
+    std::vector<bool> visited(size_t(n + 1) * (n + 1) * symbols, false);
+    std::vector<CykParser::Child> stack{{g.start, false, 0, n}};
+    visited[slot(g.start, 0, n)] = true;
+    while (!stack.empty()) {
+        CykParser::Child node = stack.back();
+        stack.pop_back();
+        if (looping[node.symbol])
+            return true;
+        for (const CykParser::Alternative& alternative : parser.alternatives(node.from, node.to, node.symbol)) {
+            if (alternative.split < 0)
+                continue;
+            const auto& rule = g.binary[alternative.rule];
+            for (CykParser::Child child : {CykParser::Child{rule.left, false, node.from, alternative.split},
+                                           CykParser::Child{rule.right, false, alternative.split, node.to}}) {
+                if (visited[slot(child.symbol, child.from, child.to)])
+                    continue;
+                visited[slot(child.symbol, child.from, child.to)] = true;
+                stack.push_back(child);
+            }
+        }
+    }
+    return false;
+}
+
+bool AmbiguityAnalyzer::isAmbiguous(const QList<int> &word)
+{
+    quint64 derivations = counter.exactCount(word);
+    return derivations >= 2 || (derivations == 1 && hasLoops && throughLoop(word));
+}
+
+bool AmbiguityAnalyzer::search(const QList<Choice> &active, int length, QList<int> &prefix)
+{
+    if (!spend())
+        return false;
+    QList<Choice> remaining;
+    for (const Choice& choice : active)
+        if (weight(choice, prefix, length) > 0)
+            remaining.append(choice);
+    if (remaining.size() < 2)
+        return false;
+    if (prefix.size() == length)
+        return true;
+
+    for (int t = 0; t < g.terminals.size(); ++t) {
+        prefix.append(t);
+        if (search(remaining, length, prefix))
+            return true;
+        prefix.removeLast();
+    }
+    return false;
+}
+
+void AmbiguityAnalyzer::collectAmbiguous(QList<int> &prefix, int wordLimit, QStringList &out)
+{
+    if (out.size() >= wordLimit)
+        return;
+    permille = 900 + int(100 * (kWordsBudget - budget) / kWordsBudget);
+    if (!spend())
+        return;
+    if (!prefix.isEmpty() && isAmbiguous(prefix))
+        out.append(g.fromTerminals(prefix));
+    if (prefix.size() >= limit)
+        return;
+
+    for (int t = 0; t < g.terminals.size() && out.size() < wordLimit; ++t) {
+        prefix.append(t);
+        // С петлёй неоднозначной может оказаться и единственная цепочка.
+        if (counter.prefixCount(prefix, 1, limit) >= (hasLoops ? 1 : 2))
+            collectAmbiguous(prefix, wordLimit, out);
+        prefix.removeLast();
+    }
+}
@@ -0,0 +1,88 @@
+#ifndef AMBIGUITY_H
+#define AMBIGUITY_H
+
+#include "chaincounter.h"
+#include "cykparser.h"
+#include "shortestwords.h"
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <functional>
+
+struct AmbiguityReport {
+    QList<quint64> derivationsPerLength;   // индекс — длина цепочки
+    bool ambiguous = false;
+    bool complete = true;                  // поиск не упёрся в ограничение перебора
+    bool infinite = false;                 // есть достижимая петля A -> A
+    QString witness;
+    QString firstTree;
+    QString secondTree;
+    QStringList ambiguousWords;
+};
+
+// Поиск неоднозначности по бинарной форме.
+//
+// Кратчайший свидетель ищется как минимум по нетерминалам A величины
+// |контекст(A)| + |u|, где u — кратчайшая цепочка, которую A выводит двумя
+// разными первыми шагами (правило и точка разбиения). Цепочки u перебираются
+// по префиксам, и префикс отсекается, как только согласованным с ним
+// остаётся меньше двух первых шагов. Если у правил A общий левый потомок,
+// отсекать нечего и перебор сводится к перебору цепочек данной длины,
+// поэтому он ограничен, а на каждый префикс пересчитывается таблица
+// префиксов ChainCounter. Анализ может идти долго: из интерфейса его
+// запускают вне потока GUI с возможностью прервать.
+//
+// Петля A -> A в таблицы не входит, но делает неоднозначной любую цепочку,
+// в выводе которой есть A; такие цепочки тоже считаются свидетелями.
+class AmbiguityAnalyzer
+{
+public:
+    AmbiguityAnalyzer(const Grammars::IndexedGrammar& grammar, int maxLength);
+
+    AmbiguityReport analyze(int wordLimit = 20);
+    // Вызывается из analyze() с долей выполненной работы в тысячных;
+    // false прерывает поиск, и отчёт получается неполным.
+    void setProgress(std::function<bool(int)> callback) { progress = std::move(callback); }
+    bool wasCanceled() const { return canceled; }
+    static QString treeToString(const CykParser& parser, const CykParser::Tree& tree);
+
+private:
+    struct Choice {
+        int left;
+        int right;
+        int split;
+        int terminal;   // для правил A -> t, иначе -1
+    };
+
+    Grammars::IndexedGrammar g;
+    ChainCounter counter;
+    ShortestWords shortest;
+    CykParser parser;
+    int limit;
+    qint64 budget = 0;
+    bool exhausted = false;
+    std::function<bool(int)> progress;
+    int permille = 0;
+    bool canceled = false;
+
+    QList<int> minLength;
+    QList<int> context;
+    QList<int> contextRule;
+    QList<bool> looping;    // петля A -> A на достижимом продуктивном A
+    bool hasLoops = false;
+
+    void computeShortest();
+    void computeContexts();
+    void contextWords(int nonterminal, QList<int>& left, QList<int>& right) const;
+    QList<Choice> choices(int nonterminal, int length) const;
+    quint64 weight(const Choice& choice, const QList<int>& prefix, int length);
+    bool spend();
+    bool findLocal(int nonterminal, int length, QList<int>& word);
+    bool throughLoop(const QList<int>& word);
+    bool isAmbiguous(const QList<int>& word);
+    bool search(const QList<Choice>& active, int length, QList<int>& prefix);
+    void collectAmbiguous(QList<int>& prefix, int wordLimit, QStringList& out);
+};
+
+#endif // AMBIGUITY_H
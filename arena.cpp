@@ -0,0 +1,48 @@
+#include "arena.h"
+
+#include <algorithm>
+
+Arena::Arena(size_t blockSize)
+    : blockSize(blockSize)
+{
+}
+
+Arena::~Arena()
+{
+    for (const Block& block : blocks)
+        delete[] block.data;
+}
+
+void* Arena::allocate(size_t size, size_t alignment)
+{
+    while (current < blocks.size()) {
+        Block& block = blocks[current];
+        size_t aligned = (offset + alignment - 1) / alignment * alignment;
+        if (aligned + size <= block.size) {
+            offset = aligned + size;
+            return block.data + aligned;
+        }
+        ++current;
+        offset = 0;
+    }
+
+    size_t capacity = std::max(blockSize, size + alignment);
+    blocks.push_back({new char[capacity], capacity});
+    current = blocks.size() - 1;
+    offset = 0;
+    return allocate(size, alignment);
+}
+
+void Arena::reset()
+{
+    current = 0;
+    offset = 0;
+}
+
+size_t Arena::bytesUsed() const
+{
+    size_t result = offset;
+    for (size_t i = 0; i < current && i < blocks.size(); ++i)
+        result += blocks[i].size;
+    return result;
+}
@@ -0,0 +1,40 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <vector>
+
+// Простой bump-аллокатор: память выделяется блоками и освобождается целиком.
+// После reset() блоки переиспользуются, так что повторные прогоны не
+// обращаются к куче.
+class Arena
+{
+public:
+    explicit Arena(size_t blockSize = 64 * 1024);
+    ~Arena();
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+    template<typename T>
+    T* allocateArray(size_t count) {
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    void reset();
+    size_t bytesUsed() const;
+    size_t blockCount() const { return blocks.size(); }
+
+private:
+    struct Block {
+        char* data;
+        size_t size;
+    };
+
+    size_t blockSize;
+    std::vector<Block> blocks;
+    size_t current = 0;
+    size_t offset = 0;
+};
+
+#endif // ARENA_H
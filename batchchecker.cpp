@@ -0,0 +1,203 @@
+#include "batchchecker.h"
+#include "profiler.h"
+
+#include <QFile>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+static const qint64 kBatchBytes = 256 * 1024;
+static const int kBatchesPerThread = 4;
+
+BatchChecker::BatchChecker(const Grammars::IndexedGrammar &grammar, int threads, int maxWordLength)
+    : threads(std::max(threads, 1))
+    , maxWordLength(std::clamp(maxWordLength, 1, int(kBatchBytes / 2)))
+    , recognizers(this->threads * kBatchesPerThread, CykRecognizer(grammar))
+    , batches(this->threads * kBatchesPerThread)
+{
+    pool.setMaxThreadCount(this->threads);
+}
+
+bool BatchChecker::run(const QString &path, QIODevice &output, QString &error)
+{
+    PROFILE_SCOPE("BatchChecker::run");
+    total = BatchStats();
+    QFile input;
+    bool opened = path == "-" ? input.open(stdin, QIODevice::ReadOnly)
+                              : (input.setFileName(path), input.open(QIODevice::ReadOnly));
+    if (!opened) {
+        error = "Не удалось открыть " + path + ": " + input.errorString();
+        return false;
+    }
+
+    if (!input.isSequential()) {
+        if (input.size() == 0)
+            return true;
+        // Страницы отображения берутся из файла и вытесняются ядром,
+        // так что даже очень большой файл не расходует память процесса.
+        if (const uchar* data = input.map(0, input.size()))
+            return runMapped(reinterpret_cast<const char*>(data), input.size(), output);
+    }
+    for (Batch& batch : batches)
+        batch.storage.resize(kBatchBytes);
+    carry.clear();
+    carry.reserve(kBatchBytes);
+    return runStream(input, output);
+}
+
+bool BatchChecker::runMapped(const char *data, qint64 size, QIODevice &output)
+{
+    qint64 position = 0;
+    while (position < size) {
+        int count = 0;
+        while (count < int(batches.size()) && position < size) {
+            qint64 end = std::min(position + kBatchBytes, size);
+            if (end < size) {
+                const void* newline = std::memchr(data + end, '\n', size - end);
+                end = newline ? static_cast<const char*>(newline) - data + 1 : size;
+            }
+            Batch& batch = batches[count++];
+            batch.data = data + position;
+            batch.size = end - position;
+            batch.truncated = false;
+            position = end;
+        }
+        if (!processRound(count, output))
+            return false;
+    }
+    return true;
+}
+
+bool BatchChecker::runStream(QIODevice &input, QIODevice &output)
+{
+    bool more = true;
+    while (more) {
+        int count = 0;
+        while (count < int(batches.size()) && more) {
+            more = fillFromStream(batches[count], input);
+            if (batches[count].size > 0)
+                ++count;
+        }
+        if (!processRound(count, output))
+            return false;
+    }
+    return true;
+}
+
+bool BatchChecker::fillFromStream(Batch &batch, QIODevice &input)
+{
+    // Блок начинается с хвоста предыдущего: строки, не дочитанной до '\n'.
+    char* buffer = batch.storage.data();
+    qint64 filled = carry.size();
+    std::copy(carry.begin(), carry.end(), buffer);
+    carry.clear();
+
+    bool more = true;
+    while (filled < kBatchBytes) {
+        qint64 read = input.read(buffer + filled, kBatchBytes - filled);
+        if (read <= 0) {
+            more = false;
+            break;
+        }
+        filled += read;
+    }
+
+    batch.data = buffer;
+    batch.truncated = false;
+    if (!more) {
+        batch.size = filled;
+        return false;
+    }
+
+    const char* end = buffer + filled;
+    const char* last = end;
+    while (last > buffer && last[-1] != '\n')
+        --last;
+    if (last > buffer) {
+        batch.size = last - buffer;
+        carry.assign(last, end);
+        return true;
+    }
+
+    // Строка длиннее блока заведомо длиннее maxWordLength: пропускаем её до конца.
+    batch.size = filled;
+    batch.truncated = true;
+    char symbol;
+    while (input.getChar(&symbol)) {
+        if (symbol == '\n')
+            return true;
+    }
+    return false;
+}
+
+bool BatchChecker::processRound(int count, QIODevice &output)
+{
+    if (count == 0)
+        return true;
+    for (int i = 0; i < count; ++i)
+        pool.start([this, i] { process(batches[i], recognizers[i]); });
+    pool.waitForDone();
+
+    for (int i = 0; i < count; ++i) {
+        const Batch& batch = batches[i];
+        if (echo && output.write(batch.output) != batch.output.size())
+            return false;
+        total.words += batch.stats.words;
+        total.accepted += batch.stats.accepted;
+        total.rejected += batch.stats.rejected;
+        total.skipped += batch.stats.skipped;
+        total.bytes += batch.stats.bytes;
+        total.longest = std::max(total.longest, batch.stats.longest);
+    }
+    return true;
+}
+
+void BatchChecker::process(Batch &batch, CykRecognizer &recognizer) const
+{
+    batch.stats = BatchStats();
+    batch.stats.bytes = batch.size;
+    batch.output.resize(0);
+
+    const char* position = batch.data;
+    const char* end = batch.data + batch.size;
+    while (position < end) {
+        const char* newline = static_cast<const char*>(std::memchr(position, '\n', end - position));
+        const char* lineEnd = newline ? newline : end;
+        int size = int(std::min<qint64>(lineEnd - position, INT_MAX));
+        if (size > 0 && position[size - 1] == '\r')
+            --size;
+
+        int length = size;
+        if (length > maxWordLength)   // в UTF-8 символ может занимать несколько байт
+            length = int(std::count_if(position, position + size, [](char c) { return (c & 0xC0) != 0x80; }));
+        bool tooLong = length > maxWordLength || (batch.truncated && !newline);
+
+        ++batch.stats.words;
+        if (tooLong) {
+            ++batch.stats.skipped;
+            appendLine(batch, "skip", position, std::min(size, maxWordLength));
+        } else {
+            batch.stats.longest = std::max(batch.stats.longest, length);
+            bool accepted = lrTable ? lrTable->acceptsUtf8(position, size, batch.stack)
+                                    : recognizer.acceptsUtf8(position, size);
+            if (accepted) {
+                ++batch.stats.accepted;
+                appendLine(batch, "accept", position, size);
+            } else {
+                ++batch.stats.rejected;
+                appendLine(batch, "reject", position, size);
+            }
+        }
+        position = newline ? newline + 1 : end;
+    }
+}
+
+void BatchChecker::appendLine(Batch &batch, const char *result, const char *word, int size) const
+{
+    if (!echo)
+        return;
+    batch.output.append(result);
+    batch.output.append('\t');
+    batch.output.append(word, size);
+    batch.output.append('\n');
+}
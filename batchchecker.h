@@ -0,0 +1,72 @@
+#ifndef BATCHCHECKER_H
+#define BATCHCHECKER_H
+
+#include "cykrecognizer.h"
+#include "lrtable.h"
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QString>
+#include <QThreadPool>
+#include <memory>
+#include <vector>
+
+struct BatchStats {
+    quint64 words = 0;
+    quint64 accepted = 0;
+    quint64 rejected = 0;
+    quint64 skipped = 0;    // длиннее maxWordLength
+    quint64 bytes = 0;
+    int longest = 0;
+};
+
+// Потоковая проверка принадлежности цепочек языку: по одной цепочке на
+// строку, из файла (отображается в память) или из стандартного ввода.
+// Вход режется на блоки по границам строк, блоки одного раунда проверяются
+// пулом потоков, а результаты пишутся в исходном порядке. Число блоков в
+// полёте и их размер фиксированы, поэтому память не зависит от размера входа.
+class BatchChecker
+{
+public:
+    BatchChecker(const Grammars::IndexedGrammar& grammar, int threads, int maxWordLength);
+
+    // Если echo == false, печатается только итоговая статистика.
+    void setEcho(bool value) { echo = value; }
+    // Для грамматики без конфликтов LALR(1) цепочки проверяются за линейное
+    // время по таблице, иначе — CYK.
+    void setLrTable(std::shared_ptr<const LrTable> table) { lrTable = std::move(table); }
+
+    // path == "-" — стандартный ввод.
+    bool run(const QString& path, QIODevice& output, QString& error);
+    const BatchStats& stats() const { return total; }
+
+private:
+    struct Batch {
+        const char* data = nullptr;
+        qint64 size = 0;
+        bool truncated = false;     // последняя строка не поместилась в блок
+        QByteArray storage;
+        QByteArray output;
+        std::vector<int> stack;     // стек разбора LR
+        BatchStats stats;
+    };
+
+    int threads;
+    int maxWordLength;
+    QThreadPool pool;
+    bool echo = true;
+    std::shared_ptr<const LrTable> lrTable;
+    std::vector<CykRecognizer> recognizers;
+    std::vector<Batch> batches;
+    std::vector<char> carry;
+    BatchStats total;
+
+    bool runMapped(const char* data, qint64 size, QIODevice& output);
+    bool runStream(QIODevice& input, QIODevice& output);
+    bool fillFromStream(Batch& batch, QIODevice& input);
+    bool processRound(int count, QIODevice& output);
+    void process(Batch& batch, CykRecognizer& recognizer) const;
+    void appendLine(Batch& batch, const char* result, const char* word, int size) const;
+};
+
+#endif // BATCHCHECKER_H
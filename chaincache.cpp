@@ -0,0 +1,105 @@
+#include "chaincache.h"
+#include "chaingenerator.h"
+#include "profiler.h"
+#include "resultcache.h"
+
+#include <QSet>
+#include <algorithm>
+
+// До этого числа выводов цепочки строятся ChainGenerator'ом: при малой
+// неоднозначности это быстрее пошагового next() по таблице префиксов.
+// Генератор проходит все выводы длины до наибольшей запрошенной (короче
+// минимальной отбрасываются только в листьях), поэтому ограничивается их
+// общее число, а не число выводов одной длины.
+static const quint64 kMaxGeneratorDerivations = 1 << 16;
+
+ChainCache::ChainCache(const Grammars::IndexedGrammar &grammar)
+    : chainCounter(grammar, 0)
+{
+}
+
+void ChainCache::setStore(const ResultCache *cache)
+{
+    store = cache;
+    if (store && grammarFingerprint.isEmpty())
+        grammarFingerprint = ResultCache::fingerprint(grammar());
+}
+
+const QStringList &ChainCache::words(int length)
+{
+    if (length >= 0 && !lookup(length))
+        build(length, length);
+    return byLength[length];
+}
+
+QStringList ChainCache::words(int minLength, int maxLength)
+{
+    // Недостающие длины окна строятся вместе, одним проходом генератора.
+    int missing = -1;
+    for (int length = std::max(minLength, 0); length <= maxLength; ++length)
+        if (!lookup(length) && missing < 0)
+            missing = length;
+    if (missing >= 0)
+        build(missing, maxLength);
+
+    QStringList result;
+    for (int length = std::max(minLength, 0); length <= maxLength; ++length)
+        result.append(byLength[length]);
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+bool ChainCache::lookup(int length)
+{
+    if (byLength.contains(length))
+        return true;
+    QStringList result;
+    if (!store || !store->get(key(length), result))
+        return false;
+    byLength.insert(length, result);
+    return true;
+}
+
+void ChainCache::build(int minLength, int maxLength)
+{
+    PROFILE_SCOPE("ChainCache::words");
+    chainCounter.extend(maxLength);
+    QList<QStringList> lists(maxLength - minLength + 1);
+    if (chainCounter.count(1, maxLength) <= kMaxGeneratorDerivations) {
+        // Перебор выводов без выделений памяти; повторы неоднозначных
+        // цепочек схлопывает множество.
+        QSet<QString> chains;
+        ChainGenerator(grammar(), maxLength).collect(minLength, chains);
+        for (const QString& chain : chains)
+            lists[chain.length() - minLength].append(chain);
+    } else {
+        // Выводов намного больше, чем цепочек может поместиться в список:
+        // перебор по существованию вывода даёт каждую цепочку один раз.
+        for (int length = minLength; length <= maxLength; ++length) {
+            if (byLength.contains(length))
+                continue;
+            QString word;
+            if (length == 0 ? grammar().acceptsEmpty : chainCounter.unrank(0, length, length, word)) {
+                do {
+                    lists[length - minLength].append(word);
+                } while (length > 0 && chainCounter.next(word, length, length));
+            }
+        }
+    }
+
+    for (int length = minLength; length <= maxLength; ++length) {
+        if (byLength.contains(length))
+            continue;
+        QStringList& result = lists[length - minLength];
+        std::sort(result.begin(), result.end());
+        PROFILE_COUNT(WordsFound, result.size());
+        if (store)
+            store->put(key(length), result);
+        byLength.insert(length, result);
+    }
+}
+
+QByteArray ChainCache::key(int length) const
+{
+    return ResultCache::key(grammarFingerprint, "words", {QString::number(length)});
+}
@@ -0,0 +1,46 @@
+#ifndef CHAINCACHE_H
+#define CHAINCACHE_H
+
+#include "chaincounter.h"
+
+#include <QByteArray>
+#include <QMap>
+#include <QStringList>
+
+class ResultCache;
+
+// Цепочки языка, разложенные по длинам, для одной грамматики. Каждая длина
+// вычисляется один раз: расширение окна [min, max] досчитывает только новые
+// длины, сужение берёт уже готовые. Кэш живёт, пока не сменилась грамматика,
+// поэтому владелец просто создаёт новый объект при её изменении.
+class ChainCache
+{
+public:
+    explicit ChainCache(const Grammars::IndexedGrammar& grammar);
+
+    ChainCounter& counter() { return chainCounter; }
+    const Grammars::IndexedGrammar& grammar() const { return chainCounter.grammar(); }
+
+    // Различные цепочки ровно этой длины в лексикографическом порядке.
+    const QStringList& words(int length);
+    // Цепочки длины из [minLength, maxLength] в лексикографическом порядке.
+    QStringList words(int minLength, int maxLength);
+    bool isCached(int length) const { return byLength.contains(length); }
+
+    // Дисковый кэш: недостающие длины сначала ищутся в нём, посчитанные
+    // записываются в него. Ключ — отпечаток бинарной формы грамматики.
+    void setStore(const ResultCache* cache);
+
+private:
+    ChainCounter chainCounter;
+    QMap<int, QStringList> byLength;
+    const ResultCache* store = nullptr;
+    QByteArray grammarFingerprint;
+
+    bool lookup(int length);
+    // Строит недостающие длины из [minLength, maxLength].
+    void build(int minLength, int maxLength);
+    QByteArray key(int length) const;
+};
+
+#endif // CHAINCACHE_H
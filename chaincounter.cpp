@@ -0,0 +1,324 @@
+#include "chaincounter.h"
+
+#include <algorithm>
+
+ChainCounter::ChainCounter(const Grammars::IndexedGrammar &grammar, int maxLength)
+    : g(grammar)
+    , limit(0)
+    , symbols(grammar.nonterminals.size())
+    , counts(symbols, 0)
+    , inside(1)
+{
+    extend(maxLength);
+}
+
+void ChainCounter::extend(int maxLength)
+{
+    if (maxLength <= limit)
+        return;
+    const int first = limit + 1;
+    limit = maxLength;
+    counts.resize(static_cast<size_t>(limit + 1) * symbols, 0);
+    // Таблица префиксов размечена по limit, столбцы inside от него не зависят.
+    prefixTableValid = false;
+
+    if (first == 1)
+        for (const auto& rule : g.unary)
+            counts[symbols + rule.lhs] = saturatingAdd(counts[symbols + rule.lhs], 1);
+
+    for (int length = std::max(first, 2); length <= limit; ++length) {
+        quint64* row = counts.data() + static_cast<size_t>(length) * symbols;
+        for (const auto& rule : g.binary) {
+            quint64 sum = row[rule.lhs];
+            for (int k = 1; k < length; ++k) {
+                quint64 left = counts[static_cast<size_t>(k) * symbols + rule.left];
+                if (left == 0) continue;
+                sum = saturatingAdd(sum, saturatingMul(left, counts[static_cast<size_t>(length - k) * symbols + rule.right]));
+            }
+            row[rule.lhs] = sum;
+        }
+    }
+}
+
+quint64 ChainCounter::nonterminalCount(int nonterminal, int length) const
+{
+    if (length == 0)
+        return nonterminal == g.start && g.acceptsEmpty ? 1 : 0;
+    if (length < 0 || length > limit || nonterminal < 0)
+        return 0;
+    return counts[static_cast<size_t>(length) * symbols + nonterminal];
+}
+
+quint64 ChainCounter::count(int minLength, int maxLength) const
+{
+    quint64 result = 0;
+    for (int length = std::max(minLength, 0); length <= std::min(maxLength, limit); ++length)
+        result = saturatingAdd(result, nonterminalCount(g.start, length));
+    return result;
+}
+
+quint64 ChainCounter::exactCount(const QList<int> &word)
+{
+    if (word.isEmpty())
+        return g.acceptsEmpty ? 1 : 0;
+    setPrefix(word);
+    return insideAt(0, word.size(), g.start);
+}
+
+quint64 ChainCounter::prefixCount(const QList<int> &word, int minLength, int maxLength)
+{
+    maxLength = std::min(maxLength, limit);
+    if (word.isEmpty())
+        return count(minLength, maxLength);
+    if (word.size() > maxLength)
+        return 0;
+    setPrefix(word);
+    buildPrefixTable();
+    quint64 result = 0;
+    for (int length = std::max<int>(minLength, word.size()); length <= maxLength; ++length)
+        result = saturatingAdd(result, prefixAt(0, length, g.start));
+    return result;
+}
+
+quint64 ChainCounter::prefixCount(int nonterminal, const QList<int> &word, int length)
+{
+    if (word.isEmpty())
+        return nonterminalCount(nonterminal, length);
+    if (length < word.size() || length > limit)
+        return 0;
+    setPrefix(word);
+    buildPrefixTable();
+    return prefixAt(0, length, nonterminal);
+}
+
+quint64 ChainCounter::overlapCount(const QList<int> &word, int from, int length, int nonterminal)
+{
+    if (from >= word.size())
+        return nonterminalCount(nonterminal, length);
+    if (length <= 0)
+        return 0;
+    setPrefix(word);
+    if (length <= word.size() - from)
+        return insideAt(from, from + length, nonterminal);
+    if (length > limit)
+        return 0;
+    buildPrefixTable();
+    return prefixAt(from, length, nonterminal);
+}
+
+quint64 ChainCounter::rank(const QString &word, int minLength, int maxLength)
+{
+    quint64 result = 0;
+    QList<int> current;
+    for (int i = 0; i < word.length(); ++i) {
+        setPrefix(current);
+        if (isWord(minLength, maxLength))
+            result = saturatingAdd(result, exactCount(current));
+
+        for (int t = 0; t < g.terminals.size() && g.terminals[t] < QString(word[i]); ++t) {
+            current.append(t);
+            result = saturatingAdd(result, prefixCount(current, minLength, maxLength));
+            current.removeLast();
+        }
+
+        int terminal = g.terminalIndex(word[i]);
+        if (terminal < 0)
+            break;
+        current.append(terminal);
+    }
+    return result;
+}
+
+bool ChainCounter::unrank(quint64 index, int minLength, int maxLength, QString &word)
+{
+    maxLength = std::min(maxLength, limit);
+    QList<int> current;
+    while (true) {
+        setPrefix(current);
+        if (isWord(minLength, maxLength)) {
+            quint64 weight = exactCount(current);
+            if (index < weight) {
+                word = g.fromTerminals(current);
+                return true;
+            }
+            index -= weight;
+        }
+        if (current.size() >= maxLength)
+            return false;
+
+        bool found = false;
+        for (int t = 0; t < g.terminals.size() && !found; ++t) {
+            current.append(t);
+            quint64 weight = prefixCount(current, minLength, maxLength);
+            if (index < weight)
+                found = true;
+            else {
+                index -= weight;
+                current.removeLast();
+            }
+        }
+        if (!found)
+            return false;
+    }
+}
+
+bool ChainCounter::next(QString &word, int minLength, int maxLength)
+{
+    maxLength = std::min(maxLength, limit);
+    QList<int> current;
+    if (!g.toTerminals(word, current))
+        return false;
+
+    int from = 0;
+    while (true) {
+        if (current.size() < maxLength) {
+            for (int t = from; t < g.terminals.size(); ++t) {
+                current.append(t);
+                if (prefixCount(current, minLength, maxLength) > 0 && descend(current, minLength, maxLength)) {
+                    word = g.fromTerminals(current);
+                    return true;
+                }
+                current.removeLast();
+            }
+        }
+        if (current.isEmpty())
+            return false;
+        from = current.last() + 1;
+        current.removeLast();
+    }
+}
+
+QStringList ChainCounter::page(quint64 from, int size, int minLength, int maxLength)
+{
+    QString word;
+    if (size <= 0 || !unrank(from, minLength, maxLength, word))
+        return {};
+    return pageFrom(word, size, minLength, maxLength);
+}
+
+QStringList ChainCounter::pageFrom(const QString &first, int size, int minLength, int maxLength)
+{
+    QStringList result;
+    QString word = first;
+    QList<int> current;
+    bool isFirstWord = g.toTerminals(word, current) && current.size() <= limit;
+    if (isFirstWord) {
+        setPrefix(current);
+        isFirstWord = isWord(minLength, std::min(maxLength, limit));
+    }
+    if (size <= 0 || (!isFirstWord && !next(word, minLength, maxLength)))
+        return result;
+    result.append(word);
+    while (result.size() < size && next(word, minLength, maxLength))
+        result.append(word);
+    return result;
+}
+
+void ChainCounter::setPrefix(const QList<int> &word)
+{
+    int common = 0;
+    while (common < word.size() && common < prefix.size() && word[common] == prefix[common])
+        ++common;
+    if (common == word.size() && common == prefix.size())
+        return;
+
+    prefix = word;
+    prefixTableValid = false;
+    inside.resize(common + 1);
+    for (int to = common + 1; to <= prefix.size(); ++to) {
+        std::vector<quint64> column(static_cast<size_t>(to) * symbols, 0);
+        for (int from = to - 1; from >= 0; --from) {
+            quint64* cell = column.data() + static_cast<size_t>(from) * symbols;
+            if (to - from == 1) {
+                for (const auto& rule : g.unary)
+                    if (rule.terminal == prefix[from])
+                        cell[rule.lhs] = saturatingAdd(cell[rule.lhs], 1);
+                continue;
+            }
+            for (int split = from + 1; split < to; ++split) {
+                const quint64* left = inside[split].data() + static_cast<size_t>(from) * symbols;
+                const quint64* right = column.data() + static_cast<size_t>(split) * symbols;
+                for (const auto& rule : g.binary) {
+                    if (left[rule.left] == 0 || right[rule.right] == 0) continue;
+                    cell[rule.lhs] = saturatingAdd(cell[rule.lhs], saturatingMul(left[rule.left], right[rule.right]));
+                }
+            }
+        }
+        inside.push_back(std::move(column));
+    }
+}
+
+void ChainCounter::buildPrefixTable()
+{
+    if (prefixTableValid)
+        return;
+    const int n = prefix.size();
+    prefixTable.assign(static_cast<size_t>(n) * (limit + 1) * symbols, 0);
+
+    // prefixAt(i, len, A) — число выводов из A цепочек длины len, начинающихся
+    // с prefix[i..n). Для len <= n - i это просто точное совпадение с подцепочкой.
+    for (int from = n - 1; from >= 0; --from) {
+        const int rest = n - from;
+        for (int length = rest; length <= limit; ++length) {
+            quint64* cell = prefixTable.data() + (static_cast<size_t>(from) * (limit + 1) + length) * symbols;
+            if (length == rest) {
+                for (int a = 0; a < symbols; ++a)
+                    cell[a] = insideAt(from, n, a);
+                continue;
+            }
+            for (const auto& rule : g.binary) {
+                quint64 sum = cell[rule.lhs];
+                for (int k = 1; k < length; ++k) {
+                    quint64 value = k >= rest
+                        ? saturatingMul(prefixAt(from, k, rule.left), counts[static_cast<size_t>(length - k) * symbols + rule.right])
+                        : saturatingMul(insideAt(from, from + k, rule.left), prefixAt(from + k, length - k, rule.right));
+                    sum = saturatingAdd(sum, value);
+                }
+                cell[rule.lhs] = sum;
+            }
+        }
+    }
+    prefixTableValid = true;
+}
+
+quint64 ChainCounter::insideAt(int from, int to, int nonterminal) const
+{
+    return inside[to][static_cast<size_t>(from) * symbols + nonterminal];
+}
+
+quint64 ChainCounter::prefixAt(int from, int length, int nonterminal) const
+{
+    if (from >= prefix.size())
+        return counts[static_cast<size_t>(length) * symbols + nonterminal];
+    return prefixTable[(static_cast<size_t>(from) * (limit + 1) + length) * symbols + nonterminal];
+}
+
+bool ChainCounter::isWord(int minLength, int maxLength)
+{
+    const int n = prefix.size();
+    if (n < minLength || n > maxLength)
+        return false;
+    return n == 0 ? g.acceptsEmpty : insideAt(0, n, g.start) > 0;
+}
+
+bool ChainCounter::descend(QList<int> &word, int minLength, int maxLength)
+{
+    while (true) {
+        setPrefix(word);
+        if (isWord(minLength, maxLength))
+            return true;
+        if (word.size() >= maxLength)
+            return false;
+
+        bool found = false;
+        for (int t = 0; t < g.terminals.size() && !found; ++t) {
+            word.append(t);
+            if (prefixCount(word, minLength, maxLength) > 0)
+                found = true;
+            else
+                word.removeLast();
+        }
+        if (!found)
+            return false;
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef CHAINCOUNTER_H
+#define CHAINCOUNTER_H
+
+#include "indexedgrammar.h"
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <limits>
+#include <vector>
+
+inline quint64 saturatingAdd(quint64 a, quint64 b) {
+    return a > std::numeric_limits<quint64>::max() - b ? std::numeric_limits<quint64>::max() : a + b;
+}
+
+inline quint64 saturatingMul(quint64 a, quint64 b) {
+    if (a == 0 || b == 0) return 0;
+    return a > std::numeric_limits<quint64>::max() / b ? std::numeric_limits<quint64>::max() : a * b;
+}
+
+// Подсчёт, ранжирование и постраничный перебор цепочек языка в
+// лексикографическом порядке без построения всего множества.
+//
+// Таблицы считают выводы, поэтому rank/unrank точны для однозначных
+// грамматик; для неоднозначных цепочка занимает столько номеров, сколько у
+// неё выводов. next() и вторая половина page() опираются только на
+// существование вывода и всегда перечисляют различные цепочки.
+// Значения больше 2^64 - 1 насыщаются.
+class ChainCounter
+{
+public:
+    ChainCounter(const Grammars::IndexedGrammar& grammar, int maxLength);
+
+    const Grammars::IndexedGrammar& grammar() const { return g; }
+    int maxLength() const { return limit; }
+    // Досчитывает таблицы до новой максимальной длины, не трогая уже готовые.
+    void extend(int maxLength);
+
+    quint64 nonterminalCount(int nonterminal, int length) const;
+    quint64 count(int minLength, int maxLength) const;
+
+    quint64 exactCount(const QList<int>& word);
+    quint64 prefixCount(const QList<int>& prefix, int minLength, int maxLength);
+    quint64 prefixCount(int nonterminal, const QList<int>& prefix, int length);
+    // Выводы из nonterminal цепочек длины length, согласованных с prefix[from..):
+    // начинающихся с него, либо совпадающих с его началом, если они короче.
+    quint64 overlapCount(const QList<int>& prefix, int from, int length, int nonterminal);
+
+    quint64 rank(const QString& word, int minLength, int maxLength);
+    bool unrank(quint64 index, int minLength, int maxLength, QString& word);
+    bool next(QString& word, int minLength, int maxLength);
+    QStringList page(quint64 from, int size, int minLength, int maxLength);
+    QStringList pageFrom(const QString& first, int size, int minLength, int maxLength);
+
+private:
+    Grammars::IndexedGrammar g;
+    int limit;
+    int symbols;
+    std::vector<quint64> counts;
+
+    QList<int> prefix;
+    std::vector<std::vector<quint64>> inside;
+    std::vector<quint64> prefixTable;
+    bool prefixTableValid = false;
+
+    void setPrefix(const QList<int>& word);
+    void buildPrefixTable();
+    quint64 insideAt(int from, int to, int nonterminal) const;
+    quint64 prefixAt(int from, int length, int nonterminal) const;
+    bool isWord(int minLength, int maxLength);
+    bool descend(QList<int>& word, int minLength, int maxLength);
+};
+
+#endif // CHAINCOUNTER_H
@@ -0,0 +1,60 @@
+#include "chaingenerator.h"
+
+#include <algorithm>
+
+ChainGenerator::ChainGenerator(const Grammars::IndexedGrammar &grammar, int maxLength)
+    : limit(std::max(maxLength, 0))
+    , start(grammar.start)
+    , acceptsEmpty(grammar.acceptsEmpty)
+{
+    const int symbols = grammar.nonterminals.size();
+    const int unreachable = limit + 1;
+
+    QChar* terminalChars = arena.allocateArray<QChar>(grammar.terminals.size());
+    for (int i = 0; i < grammar.terminals.size(); ++i)
+        terminalChars[i] = grammar.terminals[i].at(0);
+    terminals = terminalChars;
+
+    shortest = arena.allocateArray<int>(symbols);
+    std::fill(shortest, shortest + symbols, unreachable);
+    for (const auto& rule : grammar.unary)
+        shortest[rule.lhs] = 1;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (const auto& rule : grammar.binary) {
+            int length = std::min(shortest[rule.left] + shortest[rule.right], unreachable);
+            if (length < shortest[rule.lhs]) {
+                shortest[rule.lhs] = length;
+                changed = true;
+            }
+        }
+    }
+
+    ruleBegin = arena.allocateArray<int>(symbols + 1);
+    rules = arena.allocateArray<Rule>(grammar.unary.size() + grammar.binary.size());
+    int next = 0;
+    for (int a = 0; a < symbols; ++a) {
+        ruleBegin[a] = next;
+        for (int index : grammar.unaryByLhs[a])
+            rules[next++] = {-1, -1, grammar.unary[index].terminal};
+        for (int index : grammar.binaryByLhs[a])
+            rules[next++] = {grammar.binary[index].left, grammar.binary[index].right, -1};
+    }
+    ruleBegin[symbols] = next;
+
+    buffer = arena.allocateArray<int>(limit + 1);
+}
+
+void ChainGenerator::collect(int minLength, QSet<QString> &result)
+{
+    PROFILE_SCOPE("ChainGenerator::collect");
+    run(minLength, [&](const int* word, int length) {
+        PROFILE_COUNT(WordsFound, 1);
+        QString chain(length, Qt::Uninitialized);
+        QChar* data = chain.data();
+        for (int i = 0; i < length; ++i)
+            data[i] = terminals[word[i]];
+        result.insert(chain);
+    });
+}
@@ -0,0 +1,116 @@
+#ifndef CHAINGENERATOR_H
+#define CHAINGENERATOR_H
+
+#include "arena.h"
+#include "indexedgrammar.h"
+#include "profiler.h"
+
+#include <QSet>
+#include <QString>
+
+// Перебор левосторонних выводов без выделения памяти на каждом шаге.
+//
+// Сентенциальная форма xAβ хранится в одном буфере длины maxLength: готовый
+// терминальный префикс x растёт слева, а ещё не раскрытые символы Aβ лежат
+// стеком у правого края. Применение правила переписывает вершину стека на
+// месте и откатывается при возврате. Таблицы правил и буфер живут в арене,
+// поэтому сам перебор к куче не обращается.
+class ChainGenerator
+{
+public:
+    ChainGenerator(const Grammars::IndexedGrammar& grammar, int maxLength);
+
+    int maxLength() const { return limit; }
+    quint64 expansions() const { return steps; }
+    // Память таблиц и буфера; во время run() она не должна расти.
+    const Arena& memory() const { return arena; }
+
+    // sink(const int* word, int length) получает индексы терминалов; буфер
+    // действителен только во время вызова. Неоднозначные цепочки приходят
+    // столько раз, сколько у них левосторонних выводов.
+    template<typename Sink>
+    void run(int minLength, Sink&& sink) {
+        steps = 0;
+        outputSize = 0;
+        pendingCount = 0;
+        pendingMin = 0;
+        if (acceptsEmpty && minLength <= 0)
+            sink(buffer, 0);
+        if (start < 0 || limit == 0 || shortest[start] > limit)
+            return;
+        push(start);
+        expand(minLength, sink);
+        pop();
+    }
+
+    void collect(int minLength, QSet<QString>& result);
+
+private:
+    struct Rule {
+        int left;
+        int right;
+        int terminal;   // >= 0 для правил A -> t
+    };
+
+    Arena arena;
+    int limit;
+    int start;
+    bool acceptsEmpty;
+    const QChar* terminals;
+    int* ruleBegin;
+    Rule* rules;
+    int* shortest;
+    int* buffer;
+
+    int outputSize = 0;
+    int pendingCount = 0;
+    int pendingMin = 0;
+    quint64 steps = 0;
+
+    void push(int symbol) {
+        buffer[limit - ++pendingCount] = symbol;
+        pendingMin += shortest[symbol];
+    }
+
+    int pop() {
+        int symbol = buffer[limit - pendingCount--];
+        pendingMin -= shortest[symbol];
+        return symbol;
+    }
+
+    template<typename Sink>
+    void expand(int minLength, Sink& sink) {
+        if (pendingCount == 0) {
+            if (outputSize >= minLength)
+                sink(buffer, outputSize);
+            return;
+        }
+
+        const int symbol = pop();
+        for (int i = ruleBegin[symbol]; i < ruleBegin[symbol + 1]; ++i) {
+            const Rule& rule = rules[i];
+            if (rule.terminal >= 0) {
+                if (outputSize + 1 + pendingMin > limit)
+                    continue;
+                ++steps;
+                PROFILE_COUNT(Expansions, 1);
+                buffer[outputSize++] = rule.terminal;
+                expand(minLength, sink);
+                --outputSize;
+                continue;
+            }
+            if (outputSize + shortest[rule.left] + shortest[rule.right] + pendingMin > limit)
+                continue;
+            ++steps;
+            PROFILE_COUNT(Expansions, 1);
+            push(rule.right);
+            push(rule.left);
+            expand(minLength, sink);
+            pop();
+            pop();
+        }
+        push(symbol);
+    }
+};
+
+#endif // CHAINGENERATOR_H
@@ -1,91 +1,148 @@
 #include "chainmodal.h"
 #include "ui_chainmodal.h"
 #include <QStandardItemModel>
+#include <algorithm>
 
-struct NodeCFG {
-    QString chain;
-    QString appliedRule;
-    std::shared_ptr<NodeCFG> parent;
-    QList<std::shared_ptr<NodeCFG>> children;
-
-    NodeCFG(const QString& chain, const QString& rule, std::shared_ptr<NodeCFG> parent = nullptr)
-        : chain(chain), appliedRule(rule), parent(parent) {}
+// Узлы дерева достраиваются при раскрытии: данные об отрезке и нетерминале
+// хранятся в самом элементе модели, а поддеревья берутся из таблицы CYK.
+enum NodeRoles {
+    FromRole = Qt::UserRole + 1,
+    ToRole,
+    SymbolRole,
+    LoadedRole
 };
 
-void generateChainsTree(const QString& targetChain, const Grammars::CFG& cfg, const QString& currentChain, std::shared_ptr<NodeCFG> parentNode = nullptr) {
-    // Если текущая цепочка совпадает с целевой цепочкой, добавляем её в дерево
-    if (currentChain == targetChain) {
-        auto newNode = std::make_shared<NodeCFG>(currentChain, "Output: " + currentChain, parentNode);
-        if (parentNode) {
-            parentNode->children.append(newNode);
-        }
-        return;
-    }
+ChainModal::ChainModal(const QString& targetChain, const Grammars::CFG& cfg, QWidget *parent)
+    : QDialog(parent)
+    , ui(new Ui::ChainModal)
+    , parser(Grammars::IndexedGrammar::fromCFG(cfg))
+    , chain(targetChain)
+{
+    init();
+}
 
-    // Если длина превышает целевую цепочку, прекращаем выполнение
-    if (currentChain.length() > targetChain.length()) return;
-
-    // Проходим по всем символам текущей цепочки
-    for (int i = 0; i < currentChain.length(); ++i) {
-        QChar symbol = currentChain[i];
-        if (cfg.rules.contains(symbol)) {
-            for (const auto& rule : cfg.rules[symbol]) {
-                QString newChain = currentChain;
-                newChain.removeAt(i);
-                for (int j = 0; j < rule.length(); ++j) {
-                    newChain.insert(i + j, rule[j]);
-                }
-
-                // Если новый вариант не равен целевой цепочке, продолжаем генерировать
-                if (newChain != targetChain) {
-                    // Рекурсивно продолжаем строить дерево
-                    generateChainsTree(targetChain, cfg, newChain, parentNode);
-                } else {
-                    // Если новый вариант равен целевой цепочке, добавляем узел
-                    QString ruleStr = QString(symbol) + " -> " + rule;
-                    auto newNode = std::make_shared<NodeCFG>(newChain, ruleStr, parentNode);
-                    if (parentNode) {
-                        parentNode->children.append(newNode);
-                    }
-                }
-            }
-        }
-    }
+ChainModal::ChainModal(const QString& targetChain, const Grammars::Homskiy& homskiy, QWidget *parent)
+    : QDialog(parent)
+    , ui(new Ui::ChainModal)
+    , parser(Grammars::IndexedGrammar::fromHomskiy(homskiy))
+    , chain(targetChain)
+{
+    init();
 }
 
-void generateAllChains(const QString& targetChain, const Grammars::CFG& cfg, std::shared_ptr<NodeCFG>& rootNode) {
-    rootNode = std::make_shared<NodeCFG>("Start: " + targetChain, "", nullptr);
-    generateChainsTree(targetChain, cfg, QString{cfg.startSymbol}, rootNode);
+void ChainModal::init()
+{
+    ui->setupUi(this);
+    this->setWindowTitle("Дерево вывода для цепочки: " + chain);
+    model = new QStandardItemModel(this);
+    ui->treeView->setModel(model);
+    connect(ui->treeView, &QTreeView::expanded, this, &ChainModal::onExpanded);
+    connect(ui->derivationLimit, &QSpinBox::valueChanged, this, &ChainModal::buildTree);
+
+    parsed = parser.parse(chain == "λ" ? QString() : chain);
+    ui->countLabel->setText(QString("Выводов: %1").arg(parsed ? parser.derivations() : 0));
+    buildTree();
+}
+
+QString ChainModal::nodeLabel(const CykParser::Child& node) const
+{
+    if (node.terminal)
+        return parser.symbolName(node);
+    QString label = QString("%1 ⇒ %2").arg(parser.symbolName(node)).arg(chain.mid(node.from, node.to - node.from));
+    quint64 count = parser.count(node.from, node.to, node.symbol);
+    if (count > 1)
+        label += QString(" (выводов: %1)").arg(count);
+    return label;
+}
+
+QString ChainModal::productionLabel(const CykParser::Child& node, const CykParser::Production& production) const
+{
+    QString rule;
+    for (const CykParser::Child& child : production)
+        rule += parser.symbolName(child);
+    return QString("%1 → %2 (выводов: %3)").arg(parser.symbolName(node)).arg(rule).arg(parser.count(production));
 }
 
-void addNodeToModel(std::shared_ptr<NodeCFG> node, QStandardItem* parentItem) {
-    QStandardItem* item = new QStandardItem(node->appliedRule.isEmpty() ? node->chain : node->appliedRule);
+void ChainModal::appendNode(const CykParser::Child& node, QStandardItem* parentItem)
+{
+    QStandardItem* item = new QStandardItem(nodeLabel(node));
+    item->setEditable(false);
     parentItem->appendRow(item);
+    if (node.terminal)
+        return;
+    item->setData(node.from, FromRole);
+    item->setData(node.to, ToRole);
+    item->setData(node.symbol, SymbolRole);
+    item->appendRow(new QStandardItem("…"));
+}
 
-    for (const auto& child : node->children) {
-        addNodeToModel(child, item);
-    }
+void ChainModal::appendTree(const CykParser::Tree& tree, QStandardItem* parentItem)
+{
+    QStandardItem* item = new QStandardItem(tree.node.terminal ? parser.symbolName(tree.node)
+                                                               : parser.symbolName(tree.node) + " ⇒ " + chain.mid(tree.node.from, tree.node.to - tree.node.from));
+    item->setEditable(false);
+    parentItem->appendRow(item);
+    for (const auto& child : tree.children)
+        appendTree(child, item);
 }
 
-ChainModal::ChainModal(const QString& targetChain, const Grammars::CFG& cfg, QWidget *parent)
-    : QDialog(parent)
-    , ui(new Ui::ChainModal)
+void ChainModal::buildTree()
 {
-    ui->setupUi(this);
-    QStandardItemModel* model = new QStandardItemModel(this);
-    model->setHorizontalHeaderLabels({"Chain Derivation"});
+    model->clear();
+    model->setHorizontalHeaderLabels({"Дерево вывода"});
 
-    std::shared_ptr<NodeCFG> rootNode;
-    generateAllChains(targetChain, cfg, rootNode);
+    const auto& grammar = parser.grammar();
+    if (!parsed) {
+        model->appendRow(new QStandardItem("Цепочка не выводится из " + grammar.nonterminals[grammar.start]));
+        return;
+    }
+    if (parser.length() == 0) {
+        model->appendRow(new QStandardItem(grammar.nonterminals[grammar.start] + " → λ"));
+        return;
+    }
 
-    QStandardItem* rootItem = new QStandardItem("Start Chain: " + targetChain);
-    model->appendRow(rootItem);
-    addNodeToModel(rootNode, rootItem);
+    CykParser::Child root{grammar.start, false, 0, parser.length()};
+    quint64 limit = ui->derivationLimit->value();
+    if (limit == 0) {
+        // Все выводы: упакованный лес, общие поддеревья строятся только при раскрытии.
+        appendNode(root, model->invisibleRootItem());
+        ui->treeView->expand(model->index(0, 0));
+        return;
+    }
 
-    ui->treeView->setModel(model);
+    for (quint64 i = 0; i < std::min(limit, parser.derivations()); ++i) {
+        QStandardItem* item = new QStandardItem(QString("Вывод №%1").arg(i + 1));
+        item->setEditable(false);
+        model->appendRow(item);
+        appendTree(parser.derivation(i, root.from, root.to, root.symbol), item);
+    }
     ui->treeView->expandAll();
 }
 
+void ChainModal::onExpanded(const QModelIndex& index)
+{
+    QStandardItem* item = model->itemFromIndex(index);
+    if (!item || !item->data(SymbolRole).isValid() || item->data(LoadedRole).toBool())
+        return;
+    item->setData(true, LoadedRole);
+    item->removeRows(0, item->rowCount());
+
+    CykParser::Child node{item->data(SymbolRole).toInt(), false, item->data(FromRole).toInt(), item->data(ToRole).toInt()};
+    QList<CykParser::Production> productions = parser.productions(node.from, node.to, node.symbol);
+    if (productions.size() == 1) {
+        for (const CykParser::Child& child : productions.first())
+            appendNode(child, item);
+        return;
+    }
+    for (const CykParser::Production& production : productions) {
+        QStandardItem* alternative = new QStandardItem(productionLabel(node, production));
+        alternative->setEditable(false);
+        item->appendRow(alternative);
+        for (const CykParser::Child& child : production)
+            appendNode(child, alternative);
+    }
+}
+
 ChainModal::~ChainModal() {
     delete ui;
 }
@@ -3,6 +3,10 @@
 
 #include <QDialog>
 #include "mainwindow.h"
+#include "cykparser.h"
+
+class QStandardItem;
+class QStandardItemModel;
 
 namespace Ui {
 class ChainModal;
@@ -19,6 +23,22 @@ public:
 
 private:
     Ui::ChainModal *ui;
+    CykParser parser;
+    QString chain;
+    // false, если цепочка не выводится. При символах не из алфавита таблица
+    // пуста, и derivations() для неё не годится (для λ-грамматики это 1).
+    bool parsed = false;
+    QStandardItemModel* model;
+
+    void init();
+    QString nodeLabel(const CykParser::Child& node) const;
+    QString productionLabel(const CykParser::Child& node, const CykParser::Production& production) const;
+    void appendNode(const CykParser::Child& node, QStandardItem* parentItem);
+    void appendTree(const CykParser::Tree& tree, QStandardItem* parentItem);
+
+private slots:
+    void buildTree();
+    void onExpanded(const QModelIndex& index);
 };
 
 #endif // CHAINMODAL_H
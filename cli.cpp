@@ -0,0 +1,472 @@
+#include "cli.h"
+#include "mainwindow.h"
+#include "profiler.h"
+#include "chaincounter.h"
+#include "chaingenerator.h"
+#include "batchchecker.h"
+#include "lrtable.h"
+#include "parallelcyk.h"
+#include "productgrammar.h"
+#include "resultcache.h"
+#include "shortestwords.h"
+#include "worditerator.h"
+
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QPair>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <QThread>
+#include <algorithm>
+#include <cstring>
+
+bool isCliInvocation(int argc, char *argv[])
+{
+    return argc > 1 && std::strncmp(argv[1], "--", 2) == 0;
+}
+
+static QStringList sortChains(const QSet<QString>& chains)
+{
+    PROFILE_SCOPE("sortChains");
+    QStringList sorted = chains.values();
+    std::sort(sorted.begin(), sorted.end());
+    return sorted;
+}
+
+static int runGenerate(Grammars::CFG cfg, int minLength, int maxLength, const ResultCache& cache, QTextStream& out)
+{
+    // Оба отсортированных списка хранятся одной записью: при попадании не
+    // выполняются ни преобразование, ни генераторы.
+    QByteArray entry = ResultCache::key(ResultCache::fingerprint(cfg), "generate",
+                                        {QString::number(minLength), QString::number(maxLength)});
+    QList<QStringList> sorted;
+    if (!cache.get(entry, sorted) || sorted.size() != 2) {
+        Grammars::Homskiy homsky = cache.homskiyFromCFG(cfg);
+
+        QSet<QString> cfgChains;
+        QMap<QString, QString> cfgTrees;
+        cfg.generateAllChains(minLength, maxLength, cfgChains, cfgTrees);
+
+        QSet<QStringList> homskiyChains;
+        QMap<QString, QString> homskiyTrees;
+        homsky.generateAllChains(minLength, maxLength, homskiyChains, homskiyTrees);
+
+        QSet<QString> homskiyJoined;
+        for (const QStringList& chain : homskiyChains)
+            homskiyJoined.insert(chain.join(""));
+
+        sorted = {sortChains(cfgChains), sortChains(homskiyJoined)};
+        cache.put(entry, sorted);
+    }
+
+    const QStringList& cfgSorted = sorted[0];
+    const QStringList& homskiySorted = sorted[1];
+    out << "КС-грамматика: " << cfgSorted.size() << " цепочек\n";
+    out << "Форма Хомского: " << homskiySorted.size() << " цепочек\n";
+    out << (cfgSorted == homskiySorted ? "Множества совпадают\n" : "Множества различаются\n");
+    return 0;
+}
+
+static int runGeneratorBenchmark(const Grammars::CFG& cfg, int minLength, int maxLength, QTextStream& out, QTextStream& err)
+{
+    Grammars::Homskiy homsky = makeHomskyFromCFG(cfg);
+    ChainGenerator generator(Grammars::IndexedGrammar::fromHomskiy(homsky), maxLength);
+    // Рост арены проверяется в любой сборке; счётчик кучи — только с профилированием.
+    const size_t arenaBlocks = generator.memory().blockCount();
+    const size_t arenaBytes = generator.memory().bytesUsed();
+    quint64 derivations = 0;
+    auto sink = [&derivations](const int*, int) { ++derivations; };
+    generator.run(minLength, sink);
+
+    // Второй прогон — установившийся режим: вся память уже выделена.
+    derivations = 0;
+    quint64 allocations = Profiler::value(Profiler::Allocations);
+    QElapsedTimer timer;
+    timer.start();
+    generator.run(minLength, sink);
+    qint64 elapsed = timer.nsecsElapsed();
+    allocations = Profiler::value(Profiler::Allocations) - allocations;
+    quint64 expansions = std::max<quint64>(generator.expansions(), 1);
+    bool arenaGrew = generator.memory().blockCount() != arenaBlocks || generator.memory().bytesUsed() != arenaBytes;
+
+    out << "ChainGenerator: " << generator.expansions() << " раскрытий, " << derivations << " выводов, "
+        << elapsed / 1e6 << " мс, " << double(elapsed) / expansions << " нс на раскрытие\n";
+    out << "Арена: блоков " << generator.memory().blockCount() << ", байт " << generator.memory().bytesUsed()
+        << (arenaGrew ? " — выросла во время перебора\n" : ", без роста\n");
+    if (Profiler::isEnabled())
+        out << "Выделений памяти: " << allocations << " (" << double(allocations) / expansions << " на раскрытие)\n";
+    else
+        err << "Выделения из кучи не проверены: счётчик есть только в сборке с CONFIG+=profiling\n";
+
+    QSet<QStringList> chains;
+    QMap<QString, QString> trees;
+    quint64 legacyExpansions = Profiler::value(Profiler::Expansions);
+    quint64 legacyAllocations = Profiler::value(Profiler::Allocations);
+    timer.restart();
+    homsky.generateAllChains(minLength, maxLength, chains, trees);
+    elapsed = timer.nsecsElapsed();
+    out << "Homskiy::generateAllChains: " << chains.size() << " цепочек, " << elapsed / 1e6 << " мс";
+    if (Profiler::isEnabled())
+        out << ", " << Profiler::value(Profiler::Expansions) - legacyExpansions << " раскрытий, "
+            << Profiler::value(Profiler::Allocations) - legacyAllocations << " выделений памяти";
+    out << "\n";
+
+    if (arenaGrew)
+        err << "ChainGenerator выделял память из арены во время перебора\n";
+    if (Profiler::isEnabled() && allocations != 0)
+        err << "ChainGenerator обращался к куче во время перебора\n";
+    return arenaGrew || (Profiler::isEnabled() && allocations != 0) ? 1 : 0;
+}
+
+static int runCheck(const Grammars::CFG& cfg, const QString& path, int threads, int maxWordLength, bool quiet,
+                    const ResultCache& cache, QTextStream& err)
+{
+    BatchChecker checker(Grammars::IndexedGrammar::fromHomskiy(cache.homskiyFromCFG(cfg)), threads, maxWordLength);
+    checker.setEcho(!quiet);
+    auto table = std::make_shared<LrTable>(cfg);
+    if (table->hasConflicts()) {
+        err << "Грамматика не LALR(1) (конфликтов: " << table->conflicts().size() << "), проверка через CYK\n";
+    } else {
+        checker.setLrTable(table);
+        err << "Проверка по таблицам LALR(1), состояний: " << table->stateCount() << "\n";
+    }
+
+    QFile output;
+    output.open(stdout, QIODevice::WriteOnly);
+    QString error;
+    QElapsedTimer timer;
+    timer.start();
+    bool ok = checker.run(path, output, error);
+    output.flush();
+    qint64 elapsed = std::max<qint64>(timer.elapsed(), 1);
+    if (!ok) {
+        err << (error.isEmpty() ? "Ошибка записи результата" : error) << "\n";
+        return 1;
+    }
+
+    const BatchStats& stats = checker.stats();
+    err << "Цепочек: " << stats.words << ", принято: " << stats.accepted << ", отвергнуто: " << stats.rejected
+        << ", пропущено (длиннее " << maxWordLength << "): " << stats.skipped << "\n";
+    err << "Прочитано байт: " << stats.bytes << ", самая длинная проверенная цепочка: " << stats.longest << "\n";
+    err << "Время: " << elapsed << " мс, " << qRound64(stats.words * 1000.0 / elapsed) << " цепочек/с, потоков: " << threads << "\n";
+    return 0;
+}
+
+static int runStream(const Grammars::CFG& cfg, int minLength, int maxLength, int first, const ResultCache& cache, QTextStream& out)
+{
+    // Цепочки печатаются по мере получения, перебор прекращается после first.
+    WordIterator words(cache.homskiyFromCFG(cfg), minLength, maxLength);
+    QString word;
+    while ((first <= 0 || words.produced() < quint64(first)) && words.next(word)) {
+        out << (word.isEmpty() ? QString("λ") : word) << "\n";
+        out.flush();
+    }
+    return 0;
+}
+
+static int runShortest(const Grammars::CFG& cfg, int first, QTextStream& out)
+{
+    ShortestWords shortest(Grammars::IndexedGrammar::fromCFG(cfg));
+    const Grammars::IndexedGrammar& grammar = shortest.grammar();
+    for (int a = 0; a < grammar.nonterminals.size(); ++a) {
+        if (grammar.synthetic[a])
+            continue;
+        out << grammar.nonterminals[a] << ": ";
+        if (shortest.length(a) < 0)
+            out << "не порождает терминальных цепочек\n";
+        else
+            out << shortest.word(a) << " (длина " << shortest.length(a) << ")\n";
+    }
+    QStringList words = shortest.shortestWords(first <= 0 ? 10 : first);
+    for (QString& word : words)
+        if (word.isEmpty())
+            word = "λ";
+    out << "Кратчайшие цепочки языка: " << words.join(", ") << "\n";
+    return 0;
+}
+
+static int runDiff(const Grammars::CFG& cfg, int minLength, int maxLength, int first, const ResultCache& cache, QTextStream& out)
+{
+    WordIterator cfgWords(cfg, minLength, maxLength);
+    WordIterator homskiyWords(cache.homskiyFromCFG(cfg), minLength, maxLength);
+    QList<WordDifference> differences = streamDiff(cfgWords, homskiyWords, first <= 0 ? 20 : first);
+    for (const WordDifference& difference : differences)
+        out << (difference.inFirst ? "< " : "> ") << (difference.word.isEmpty() ? QString("λ") : difference.word) << "\n";
+    out << "Просмотрено цепочек: " << cfgWords.produced() << " / " << homskiyWords.produced()
+        << ", различий: " << differences.size() << "\n";
+    return differences.isEmpty() ? 0 : 1;
+}
+
+static int runRegex(const Grammars::CFG& cfg, const QString& pattern, int minLength, int maxLength,
+                    bool stream, int first, int samples, const ResultCache& cache, QTextStream& out, QTextStream& err)
+{
+    Grammars::Homskiy homskiy = cache.homskiyFromCFG(cfg);
+    QString alphabet;
+    for (const QString& terminal : homskiy.terminals)
+        alphabet += terminal;
+    Dfa dfa;
+    QString error;
+    if (!Dfa::fromRegex(pattern, alphabet, dfa, error)) {
+        err << "Ошибка в выражении: " << error << "\n";
+        return 1;
+    }
+
+    ProductStats stats;
+    Grammars::Homskiy product = intersectWithDfa(homskiy, dfa, &stats);
+    if (stream) {
+        WordIterator words(product, minLength, maxLength);
+        QString word;
+        while ((first <= 0 || words.produced() < quint64(first)) && words.next(word)) {
+            out << (word.isEmpty() ? QString("λ") : word) << "\n";
+            out.flush();
+        }
+        return 0;
+    }
+
+    out << "Автомат: состояний " << stats.dfaStates << ", живых " << stats.liveStates << "\n";
+    out << "Произведение: продуктивных троек " << stats.triples << ", нетерминалов " << stats.nonterminals
+        << ", правил " << stats.rules << "\n";
+    ChainCounter counter(Grammars::IndexedGrammar::fromHomskiy(product), maxLength);
+    quint64 total = counter.count(minLength, maxLength);
+    out << "Выводов цепочек длины " << minLength << ".." << maxLength << ": " << total << "\n";
+
+    // Номер вывода выбирается равномерно, поэтому для однозначной грамматики
+    // выборка равномерна по цепочкам (произведение с ДКА однозначно, если
+    // однозначна исходная грамматика).
+    for (int i = 0; i < samples && total > 0; ++i) {
+        QString word;
+        if (counter.unrank(QRandomGenerator::global()->bounded(total), minLength, maxLength, word))
+            out << (word.isEmpty() ? QString("λ") : word) << "\n";
+    }
+    return 0;
+}
+
+static int runLalr(const Grammars::CFG& cfg, const QString& headerPath, QTextStream& out, QTextStream& err)
+{
+    LrTable table(cfg);
+    out << "LALR(1): состояний " << table.stateCount() << ", правил " << table.productionCount() << "\n";
+    if (table.hasConflicts()) {
+        out << "Конфликтов: " << table.conflicts().size() << "\n";
+        for (const LrTable::Conflict& conflict : table.conflicts())
+            out << "  " << conflict.description << "\n";
+        if (!headerPath.isEmpty())
+            err << "Заголовок не создан: грамматика не LALR(1)\n";
+        return 1;
+    }
+    out << "Конфликтов нет\n";
+    if (headerPath.isEmpty())
+        return 0;
+
+    // Имя пространства имён — из имени файла, приведённого к идентификатору C++.
+    QString name = QFileInfo(headerPath).completeBaseName();
+    for (QChar& symbol : name)
+        if (!(symbol.isLetterOrNumber() && symbol.unicode() < 128))
+            symbol = '_';
+    if (name.isEmpty() || name[0].isDigit())
+        name.prepend("Grammar_");
+
+    QFile file(headerPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        err << "Не удалось открыть " << headerPath << "\n";
+        return 1;
+    }
+    file.write(table.toCppHeader(name).toUtf8());
+    out << "Таблицы записаны в " << headerPath << " (namespace " << name << ")\n";
+    return 0;
+}
+
+// Язык непустых правильных скобочных последовательностей: S -> SS | (S) | ().
+static Grammars::Homskiy syntheticBrackets()
+{
+    Grammars::Homskiy grammar;
+    grammar.terminals = {"(", ")"};
+    grammar.nonterminals = {"S", "L", "R", "T"};
+    grammar.startSymbol = "S";
+    grammar.rules["S"] = {{"S", "S"}, {"L", "T"}, {"L", "R"}};
+    grammar.rules["T"] = {{"S", "R"}};
+    grammar.rules["L"] = {{"("}};
+    grammar.rules["R"] = {{")"}};
+    return grammar;
+}
+
+// Случайная грамматика в форме Хомского: много нетерминалов, плотная таблица.
+static Grammars::Homskiy syntheticRandom(int nonterminals, int rulesPerNonterminal, quint32 seed)
+{
+    QRandomGenerator random(seed);
+    Grammars::Homskiy grammar;
+    grammar.terminals = {"a", "b", "c", "d"};
+    QStringList names;
+    for (int i = 0; i < nonterminals; ++i)
+        names.append(i == 0 ? QString("S") : QString("N%1").arg(i));
+    grammar.nonterminals = QSet<QString>(names.begin(), names.end());
+    grammar.startSymbol = "S";
+    for (const QString& name : names) {
+        QList<QStringList>& rules = grammar.rules[name];
+        rules.append({QString(QChar('a' + random.bounded(4)))});
+        for (int i = 0; i < rulesPerNonterminal; ++i)
+            rules.append({names[random.bounded(nonterminals)], names[random.bounded(nonterminals)]});
+    }
+    return grammar;
+}
+
+static int runCykBenchmark(const QStringList& grammarFiles, int length, int maxThreads, QTextStream& out, QTextStream& err)
+{
+    QList<QPair<QString, Grammars::Homskiy>> grammars;
+    for (const QString& path : grammarFiles) {
+        Grammars::CFG cfg = parseCFGFromJson(path);
+        QString error = canonError(cfg);
+        if (!error.isEmpty()) {
+            err << path << ": " << error << "\n";
+            return 1;
+        }
+        grammars.append({path, makeHomskyFromCFG(cfg)});
+    }
+    grammars.append({"скобки (синтетическая)", syntheticBrackets()});
+    grammars.append({"случайная, 32 нетерминала (синтетическая)", syntheticRandom(32, 6, 42)});
+
+    QList<int> threadCounts;
+    for (int threads = 1; threads < maxThreads; threads *= 2)
+        threadCounts.append(threads);
+    threadCounts.append(std::max(maxThreads, 1));
+
+    for (const auto& [name, homskiy] : grammars) {
+        // Время CYK почти не зависит от того, принадлежит ли цепочка языку,
+        // поэтому берётся случайная цепочка из терминалов грамматики.
+        QStringList terminals(homskiy.terminals.begin(), homskiy.terminals.end());
+        QRandomGenerator random(length);
+        QString word;
+        word.reserve(length);
+        for (int i = 0; i < length; ++i)
+            word += terminals[random.bounded(int(terminals.size()))];
+
+        ParallelCyk cyk(homskiy);
+        out << name << ", длина " << length << ":\n";
+        double single = 0;
+        for (int threads : threadCounts) {
+            cyk.setThreadCount(threads);
+            QElapsedTimer timer;
+            timer.start();
+            bool accepted = cyk.accepts(word);
+            double elapsed = timer.nsecsElapsed() / 1e6;
+            if (threads == 1)
+                single = elapsed;
+            out << "  потоков: " << threads << ", " << elapsed << " мс, ускорение " << single / elapsed
+                << (accepted ? " (принята)" : " (отвергнута)") << "\n";
+        }
+    }
+    return 0;
+}
+
+// Общий выход всех режимов. Сводка профилирования идёт в stderr и только в
+// сборке с профилированием, чтобы не менять вывод самих режимов.
+static int finishRun(int result, const QString& tracePath, QTextStream& err)
+{
+    if (Profiler::isEnabled())
+        err << Profiler::summary() << "\n";
+    if (!tracePath.isEmpty()) {
+        if (!Profiler::isEnabled())
+            err << "Сборка без профилирования (CONFIG+=profiling), трассировка будет пустой\n";
+        if (!Profiler::exportChromeTrace(tracePath))
+            return 1;
+    }
+    return result;
+}
+
+int runCli(const QStringList &arguments)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Приведение КС-грамматики к форме Хомского без графического интерфейса");
+    parser.addHelpOption();
+    QCommandLineOption grammarOption("grammar", "JSON-файл КС-грамматики.", "file");
+    QCommandLineOption minOption("min", "Минимальная длина цепочек.", "n", "1");
+    QCommandLineOption maxOption("max", "Максимальная длина цепочек.", "n", "5");
+    QCommandLineOption traceOption("trace", "Сохранить трассировку в формате Chrome Trace.", "file");
+    QCommandLineOption benchGeneratorOption("bench-generator", "Замерить генератор без выделений памяти.");
+    QCommandLineOption checkOption("check", "Проверить цепочки из файла (по одной на строку, \"-\" — стандартный ввод).", "file");
+    QCommandLineOption threadsOption("threads", "Число потоков (для --bench-cyk — наибольшее).", "n", QString::number(QThread::idealThreadCount()));
+    QCommandLineOption maxWordOption("max-word", "Цепочки длиннее n пропускаются.", "n", "1000");
+    QCommandLineOption quietOption("quiet", "Не печатать результат для каждой цепочки.");
+    QCommandLineOption benchCykOption("bench-cyk", "Замерить параллельный CYK на цепочке длины n по числу потоков.", "n");
+    QCommandLineOption streamOption("stream", "Печатать цепочки по возрастанию длины по мере перебора (без --max — без ограничения).");
+    QCommandLineOption diffOption("diff", "Сравнить языки КС-грамматики и формы Хомского потоково.");
+    QCommandLineOption shortestOption("shortest", "Кратчайшая цепочка каждого нетерминала и n кратчайших цепочек языка (--first).");
+    QCommandLineOption firstOption("first", "Остановиться после n цепочек (--stream, --shortest) или n различий (--diff).", "n", "0");
+    QCommandLineOption lalrOption("lalr", "Построить таблицы LALR(1) и вывести конфликты.");
+    QCommandLineOption lalrHeaderOption("lalr-header", "Записать таблицы LALR(1) в заголовок C++.", "file");
+    QCommandLineOption regexOption("regex", "Пересечь язык с регулярным выражением (\"!\" в начале — дополнение); с --stream печатать цепочки.", "pattern");
+    QCommandLineOption cacheDirOption("cache-dir", "Каталог кэша результатов (по умолчанию — системный каталог кэша).", "dir");
+    QCommandLineOption noCacheOption("no-cache", "Не читать и не записывать кэш результатов.");
+    QCommandLineOption sampleOption("sample", "Для --regex: n случайных цепочек длины --min..--max.", "n", "0");
+    parser.addOptions({grammarOption, minOption, maxOption, traceOption, benchGeneratorOption,
+                       checkOption, threadsOption, maxWordOption, quietOption, benchCykOption,
+                       lalrOption, lalrHeaderOption, streamOption, diffOption, shortestOption, firstOption,
+                       regexOption, sampleOption, cacheDirOption, noCacheOption});
+    parser.process(arguments);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    QString tracePath = parser.value(traceOption);
+    if (parser.isSet(benchCykOption)) {
+        // Грамматики из --grammar (можно несколько) и синтетические.
+        return finishRun(runCykBenchmark(parser.values(grammarOption), parser.value(benchCykOption).toInt(),
+                                         parser.value(threadsOption).toInt(), out, err),
+                         tracePath, err);
+    }
+    if (!parser.isSet(grammarOption)) {
+        err << "Не указан файл грамматики (--grammar)\n";
+        return 1;
+    }
+
+    Grammars::CFG cfg = parseCFGFromJson(parser.value(grammarOption));
+    QString error = canonError(cfg);
+    if (!error.isEmpty()) {
+        err << error << "\n";
+        return 1;
+    }
+
+    ResultCache cache(parser.value(cacheDirOption));
+    cache.setEnabled(!parser.isSet(noCacheOption));
+
+    if (parser.isSet(lalrOption) || parser.isSet(lalrHeaderOption))
+        return finishRun(runLalr(cfg, parser.value(lalrHeaderOption), out, err), tracePath, err);
+
+    if (parser.isSet(shortestOption))
+        return finishRun(runShortest(cfg, parser.value(firstOption).toInt(), out), tracePath, err);
+
+    if (parser.isSet(regexOption)) {
+        // Без --max ограничение нужно только подсчёту и выборке.
+        bool unbounded = parser.isSet(streamOption) && !parser.isSet(maxOption);
+        int maxLength = unbounded ? -1 : parser.value(maxOption).toInt();
+        int result = runRegex(cfg, parser.value(regexOption), parser.value(minOption).toInt(), maxLength,
+                              parser.isSet(streamOption), parser.value(firstOption).toInt(),
+                              parser.value(sampleOption).toInt(), cache, out, err);
+        return finishRun(result, tracePath, err);
+    }
+
+    if (parser.isSet(streamOption) || parser.isSet(diffOption)) {
+        int minLength = parser.value(minOption).toInt();
+        int maxLength = parser.isSet(maxOption) ? parser.value(maxOption).toInt() : -1;
+        int first = parser.value(firstOption).toInt();
+        int result = parser.isSet(diffOption) ? runDiff(cfg, minLength, maxLength, first, cache, out)
+                                              : runStream(cfg, minLength, maxLength, first, cache, out);
+        return finishRun(result, tracePath, err);
+    }
+
+    if (parser.isSet(checkOption)) {
+        int result = runCheck(cfg, parser.value(checkOption), parser.value(threadsOption).toInt(),
+                              parser.value(maxWordOption).toInt(), parser.isSet(quietOption), cache, err);
+        return finishRun(result, tracePath, err);
+    }
+
+    int minLength = parser.value(minOption).toInt();
+    int maxLength = parser.value(maxOption).toInt();
+    int result = parser.isSet(benchGeneratorOption) ? runGeneratorBenchmark(cfg, minLength, maxLength, out, err)
+                                                    : runGenerate(cfg, minLength, maxLength, cache, out);
+
+    if (cache.isEnabled())
+        err << "Кэш результатов (" << cache.directory() << "): попаданий " << cache.hits()
+            << ", промахов " << cache.misses() << "\n";
+    return finishRun(result, tracePath, err);
+}
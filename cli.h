@@ -0,0 +1,10 @@
+#ifndef CLI_H
+#define CLI_H
+
+#include <QStringList>
+
+// Запуск без графического интерфейса: TPLHomskiy --grammar file.json ...
+bool isCliInvocation(int argc, char *argv[]);
+int runCli(const QStringList& arguments);
+
+#endif // CLI_H
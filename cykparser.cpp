@@ -0,0 +1,192 @@
+#include "cykparser.h"
+#include "chaincounter.h"
+
+#include <algorithm>
+
+CykParser::CykParser(const Grammars::IndexedGrammar &grammar)
+    : g(grammar)
+    , symbols(grammar.nonterminals.size())
+    , rulesByLeft(grammar.nonterminals.size())
+{
+    for (int i = 0; i < g.binary.size(); ++i)
+        rulesByLeft[g.binary[i].left].append(i);
+}
+
+bool CykParser::parse(const QString &word)
+{
+    QList<int> terminals;
+    if (!g.toTerminals(word, terminals)) {
+        input.clear();
+        chart.clear();
+        return false;
+    }
+    return parse(terminals);
+}
+
+bool CykParser::parse(const QList<int> &word)
+{
+    input = word;
+    const int n = input.size();
+    chart.assign(cell(0, n + 1), 0);
+
+    for (int from = 0; from < n; ++from) {
+        quint64* target = chart.data() + cell(from, from + 1);
+        for (const auto& rule : g.unary)
+            if (rule.terminal == input[from])
+                target[rule.lhs] = saturatingAdd(target[rule.lhs], 1);
+    }
+
+    for (int length = 2; length <= n; ++length) {
+        for (int from = 0; from + length <= n; ++from) {
+            const int to = from + length;
+            quint64* target = chart.data() + cell(from, to);
+            for (int split = from + 1; split < to; ++split) {
+                const quint64* left = chart.data() + cell(from, split);
+                const quint64* right = chart.data() + cell(split, to);
+                for (int b = 0; b < symbols; ++b) {
+                    if (left[b] == 0) continue;
+                    for (int index : rulesByLeft[b]) {
+                        const auto& rule = g.binary[index];
+                        if (right[rule.right] == 0) continue;
+                        target[rule.lhs] = saturatingAdd(target[rule.lhs], saturatingMul(left[b], right[rule.right]));
+                    }
+                }
+            }
+        }
+    }
+    return derivations() > 0;
+}
+
+quint64 CykParser::derivations() const
+{
+    if (input.isEmpty())
+        return g.acceptsEmpty ? 1 : 0;
+    return count(0, input.size(), g.start);
+}
+
+quint64 CykParser::count(int from, int to, int nonterminal) const
+{
+    if (from < 0 || to > input.size() || from >= to || nonterminal < 0)
+        return 0;
+    return chart[cell(from, to) + nonterminal];
+}
+
+QList<CykParser::Alternative> CykParser::alternatives(int from, int to, int nonterminal) const
+{
+    QList<Alternative> result;
+    if (count(from, to, nonterminal) == 0)
+        return result;
+
+    if (to - from == 1) {
+        for (int index : g.unaryByLhs[nonterminal])
+            if (g.unary[index].terminal == input[from])
+                result.append({index, -1});
+        return result;
+    }
+    for (int index : g.binaryByLhs[nonterminal]) {
+        const auto& rule = g.binary[index];
+        for (int split = from + 1; split < to; ++split)
+            if (count(from, split, rule.left) > 0 && count(split, to, rule.right) > 0)
+                result.append({index, split});
+    }
+    return result;
+}
+
+QList<CykParser::Production> CykParser::productions(int from, int to, int nonterminal) const
+{
+    QList<Production> result;
+    Production prefix;
+    expand(from, to, nonterminal, prefix, result);
+    return result;
+}
+
+quint64 CykParser::count(const Production &production) const
+{
+    quint64 result = 1;
+    for (const Child& child : production)
+        if (!child.terminal)
+            result = saturatingMul(result, count(child.from, child.to, child.symbol));
+    return result;
+}
+
+CykParser::Tree CykParser::derivation(quint64 index, int from, int to, int nonterminal) const
+{
+    Tree tree{{nonterminal, false, from, to}, {}};
+    for (const Production& production : productions(from, to, nonterminal)) {
+        quint64 weight = count(production);
+        if (index >= weight) {
+            index -= weight;
+            continue;
+        }
+        // Номер вывода раскладывается по потомкам в смешанной системе счисления.
+        for (int i = production.size() - 1; i >= 0; --i) {
+            const Child& child = production[i];
+            if (child.terminal) {
+                tree.children.push_back({child, {}});
+                continue;
+            }
+            quint64 base = count(child.from, child.to, child.symbol);
+            tree.children.push_back(derivation(index % base, child.from, child.to, child.symbol));
+            index /= base;
+        }
+        std::reverse(tree.children.begin(), tree.children.end());
+        break;
+    }
+    return tree;
+}
+
+QString CykParser::symbolName(const Child &child) const
+{
+    return child.terminal ? g.terminals[child.symbol] : g.nonterminals[child.symbol];
+}
+
+QStringList CykParser::leftmostDerivation(const Tree &tree) const
+{
+    QStringList result;
+    QList<const Tree*> form{&tree};
+    while (true) {
+        QString text;
+        int leftmost = -1;
+        for (int i = 0; i < form.size(); ++i) {
+            text += symbolName(form[i]->node);
+            if (leftmost < 0 && !form[i]->node.terminal)
+                leftmost = i;
+        }
+        result.append(text);
+        if (leftmost < 0)
+            return result;
+
+        const Tree* node = form[leftmost];
+        form.removeAt(leftmost);
+        for (int i = 0; i < int(node->children.size()); ++i)
+            form.insert(leftmost + i, &node->children[i]);
+    }
+}
+
+bool CykParser::isLeaf(int nonterminal) const
+{
+    return g.synthetic[nonterminal] && g.binaryByLhs[nonterminal].isEmpty();
+}
+
+void CykParser::expand(int from, int to, int nonterminal, Production &prefix, QList<Production> &out) const
+{
+    for (const Alternative& alternative : alternatives(from, to, nonterminal)) {
+        if (alternative.split < 0) {
+            prefix.append({g.unary[alternative.rule].terminal, true, from, to});
+            out.append(prefix);
+            prefix.removeLast();
+            continue;
+        }
+        const auto& rule = g.binary[alternative.rule];
+        const int split = alternative.split;
+        prefix.append(isLeaf(rule.left) ? Child{input[from], true, from, split} : Child{rule.left, false, from, split});
+        if (g.synthetic[rule.right] && !isLeaf(rule.right)) {
+            expand(split, to, rule.right, prefix, out);
+        } else {
+            prefix.append(isLeaf(rule.right) ? Child{input[split], true, split, to} : Child{rule.right, false, split, to});
+            out.append(prefix);
+            prefix.removeLast();
+        }
+        prefix.removeLast();
+    }
+}
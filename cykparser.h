@@ -0,0 +1,71 @@
+#ifndef CYKPARSER_H
+#define CYKPARSER_H
+
+#include "indexedgrammar.h"
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <vector>
+
+// Разбор Кока-Янгера-Касами по IndexedGrammar. Таблица хранит число выводов
+// каждого нетерминала на каждом отрезке цепочки и служит общим (упакованным)
+// лесом выводов: одинаковые поддеревья в ней представлены одной ячейкой.
+class CykParser
+{
+public:
+    struct Alternative {
+        int rule;   // индекс в grammar().binary, или в grammar().unary если split < 0
+        int split;
+    };
+
+    // Символ правой части исходного правила: нетерминал на отрезке или терминал.
+    struct Child {
+        int symbol;
+        bool terminal;
+        int from;
+        int to;
+    };
+    using Production = QList<Child>;
+
+    struct Tree {
+        Child node;
+        std::vector<Tree> children;
+    };
+
+    explicit CykParser(const Grammars::IndexedGrammar& grammar);
+
+    const Grammars::IndexedGrammar& grammar() const { return g; }
+    const QList<int>& word() const { return input; }
+    int length() const { return input.size(); }
+
+    bool parse(const QString& word);
+    bool parse(const QList<int>& word);
+    quint64 derivations() const;
+    quint64 count(int from, int to, int nonterminal) const;
+    QList<Alternative> alternatives(int from, int to, int nonterminal) const;
+
+    // Варианты применения правил исходной грамматики: служебные нетерминалы
+    // бинаризации раскрываются обратно в одно правило.
+    QList<Production> productions(int from, int to, int nonterminal) const;
+    quint64 count(const Production& production) const;
+    Tree derivation(quint64 index, int from, int to, int nonterminal) const;
+    QString symbolName(const Child& child) const;
+    QStringList leftmostDerivation(const Tree& tree) const;
+
+private:
+    Grammars::IndexedGrammar g;
+    int symbols;
+    QList<int> input;
+    std::vector<quint64> chart;
+    std::vector<QList<int>> rulesByLeft;
+
+    bool isLeaf(int nonterminal) const;
+    void expand(int from, int to, int nonterminal, Production& prefix, QList<Production>& out) const;
+
+    size_t cell(int from, int to) const {
+        return (static_cast<size_t>(to) * (to - 1) / 2 + from) * symbols;
+    }
+};
+
+#endif // CYKPARSER_H
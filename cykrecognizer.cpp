@@ -0,0 +1,98 @@
+#include "cykrecognizer.h"
+
+#include <QtAlgorithms>
+#include <algorithm>
+
+CykRecognizer::CykRecognizer(const Grammars::IndexedGrammar &grammar)
+    : words((grammar.nonterminals.size() + 63) / 64)
+    , start(grammar.start)
+    , acceptsEmpty(grammar.acceptsEmpty)
+{
+    std::fill(std::begin(asciiTerminals), std::end(asciiTerminals), -1);
+    for (int t = 0; t < grammar.terminals.size(); ++t) {
+        QChar symbol = grammar.terminals[t].at(0);
+        if (symbol.unicode() < 128)
+            asciiTerminals[symbol.unicode()] = t;
+        else
+            otherTerminals.insert(symbol, t);
+    }
+
+    terminalSets.assign(static_cast<size_t>(grammar.terminals.size()) * words, 0);
+    for (const auto& rule : grammar.unary)
+        terminalSets[static_cast<size_t>(rule.terminal) * words + rule.lhs / 64] |= quint64(1) << (rule.lhs % 64);
+
+    rulesBegin.assign(grammar.nonterminals.size() + 1, 0);
+    for (const auto& rule : grammar.binary)
+        ++rulesBegin[rule.left + 1];
+    for (int a = 0; a < grammar.nonterminals.size(); ++a)
+        rulesBegin[a + 1] += rulesBegin[a];
+    rulesByLeft.resize(grammar.binary.size());
+    std::vector<int> position(rulesBegin.begin(), rulesBegin.end() - 1);
+    for (const auto& rule : grammar.binary)
+        rulesByLeft[position[rule.left]++] = {rule.right, rule.lhs};
+}
+
+bool CykRecognizer::accepts(QStringView word)
+{
+    input.clear();
+    for (QChar symbol : word) {
+        int terminal = symbol.unicode() < 128 ? asciiTerminals[symbol.unicode()] : otherTerminals.value(symbol, -1);
+        if (terminal < 0)
+            return false;
+        input.push_back(terminal);
+    }
+    return recognize(static_cast<int>(input.size()));
+}
+
+bool CykRecognizer::acceptsUtf8(const char *data, int size)
+{
+    input.clear();
+    for (int i = 0; i < size; ++i) {
+        unsigned char byte = static_cast<unsigned char>(data[i]);
+        if (byte >= 128)
+            return accepts(QString::fromUtf8(data, size));
+        int terminal = asciiTerminals[byte];
+        if (terminal < 0)
+            return false;
+        input.push_back(terminal);
+    }
+    return recognize(size);
+}
+
+bool CykRecognizer::recognize(int length)
+{
+    if (length == 0)
+        return acceptsEmpty;
+    if (start < 0)
+        return false;
+
+    size_t needed = static_cast<size_t>(length + 1) * length / 2 * words;
+    if (chart.size() < needed)
+        chart.resize(needed);
+    std::fill(chart.begin(), chart.begin() + needed, 0);
+
+    for (int i = 0; i < length; ++i)
+        std::copy_n(terminalSets.data() + static_cast<size_t>(input[i]) * words, words, cell(i, i + 1));
+
+    for (int span = 2; span <= length; ++span) {
+        for (int from = 0; from + span <= length; ++from) {
+            int to = from + span;
+            quint64* target = cell(from, to);
+            for (int split = from + 1; split < to; ++split) {
+                const quint64* left = cell(from, split);
+                const quint64* right = cell(split, to);
+                for (int w = 0; w < words; ++w) {
+                    for (quint64 bits = left[w]; bits; bits &= bits - 1) {
+                        int b = w * 64 + qCountTrailingZeroBits(bits);
+                        for (int i = rulesBegin[b]; i < rulesBegin[b + 1]; ++i) {
+                            const Rule& rule = rulesByLeft[i];
+                            if (right[rule.right / 64] >> (rule.right % 64) & 1)
+                                target[rule.lhs / 64] |= quint64(1) << (rule.lhs % 64);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return cell(0, length)[start / 64] >> (start % 64) & 1;
+}
@@ -0,0 +1,47 @@
+#ifndef CYKRECOGNIZER_H
+#define CYKRECOGNIZER_H
+
+#include "indexedgrammar.h"
+
+#include <QStringView>
+#include <vector>
+
+// Распознаватель принадлежности цепочки языку (без подсчёта выводов).
+// Ячейка таблицы CYK — битовое множество нетерминалов, правила A -> BC
+// сгруппированы по B, так что перебираются только установленные биты.
+// Рабочая таблица хранится в объекте и переиспользуется между вызовами,
+// поэтому один экземпляр не должен использоваться из нескольких потоков.
+class CykRecognizer
+{
+public:
+    explicit CykRecognizer(const Grammars::IndexedGrammar& grammar);
+
+    bool accepts(QStringView word);
+    // Цепочка в UTF-8; для ASCII-символов декодирование не требуется.
+    bool acceptsUtf8(const char* data, int size);
+
+private:
+    struct Rule {
+        int right;
+        int lhs;
+    };
+
+    int words;
+    int start;
+    bool acceptsEmpty;
+    int asciiTerminals[128];
+    QHash<QChar, int> otherTerminals;
+    std::vector<quint64> terminalSets;
+    std::vector<int> rulesBegin;
+    std::vector<Rule> rulesByLeft;
+    std::vector<int> input;
+    std::vector<quint64> chart;
+
+    bool recognize(int length);
+
+    quint64* cell(int from, int to) {
+        return chart.data() + (static_cast<size_t>(to) * (to - 1) / 2 + from) * words;
+    }
+};
+
+#endif // CYKRECOGNIZER_H
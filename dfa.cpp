@@ -0,0 +1,263 @@
+#include "dfa.h"
+
+#include <QMap>
+#include <algorithm>
+#include <set>
+#include <vector>
+
+namespace {
+    // НКА Томпсона: переход по множеству символов алфавита или ε-переход.
+    struct NfaEdge {
+        int target;
+        bool epsilon;
+        QList<bool> symbols;    // для обычного перехода, по индексу в алфавите
+    };
+
+    struct Fragment {
+        int start;
+        int end;
+    };
+
+    class RegexParser
+    {
+    public:
+        RegexParser(const QString& pattern, const QString& alphabet)
+            : pattern(pattern)
+            , alphabet(alphabet)
+        {
+        }
+
+        std::vector<std::vector<NfaEdge>> states;
+        QString error;
+
+        bool parse(Fragment& result) {
+            result = alternation();
+            if (error.isEmpty() && position < pattern.size())
+                error = QString("Лишний символ '%1' в позиции %2").arg(pattern[position]).arg(position + 1);
+            return error.isEmpty();
+        }
+
+    private:
+        const QString& pattern;
+        const QString& alphabet;
+        int position = 0;
+
+        int addState() {
+            states.emplace_back();
+            return int(states.size()) - 1;
+        }
+
+        void addEpsilon(int from, int to) {
+            states[from].push_back({to, true, {}});
+        }
+
+        Fragment symbolSet(const QList<bool>& set) {
+            Fragment fragment{addState(), addState()};
+            states[fragment.start].push_back({fragment.end, false, set});
+            return fragment;
+        }
+
+        Fragment epsilonFragment() {
+            Fragment fragment{addState(), addState()};
+            addEpsilon(fragment.start, fragment.end);
+            return fragment;
+        }
+
+        bool atEnd() const { return position >= pattern.size(); }
+        QChar peek() const { return pattern[position]; }
+
+        Fragment alternation() {
+            Fragment left = concatenation();
+            while (error.isEmpty() && !atEnd() && peek() == '|') {
+                ++position;
+                Fragment right = concatenation();
+                Fragment fragment{addState(), addState()};
+                addEpsilon(fragment.start, left.start);
+                addEpsilon(fragment.start, right.start);
+                addEpsilon(left.end, fragment.end);
+                addEpsilon(right.end, fragment.end);
+                left = fragment;
+            }
+            return left;
+        }
+
+        Fragment concatenation() {
+            Fragment result = epsilonFragment();
+            while (error.isEmpty() && !atEnd() && peek() != '|' && peek() != ')') {
+                Fragment next = repetition();
+                addEpsilon(result.end, next.start);
+                result.end = next.end;
+            }
+            return result;
+        }
+
+        Fragment repetition() {
+            Fragment fragment = atom();
+            while (error.isEmpty() && !atEnd() && (peek() == '*' || peek() == '+' || peek() == '?')) {
+                QChar op = pattern[position++];
+                Fragment wrapped{addState(), addState()};
+                addEpsilon(wrapped.start, fragment.start);
+                addEpsilon(fragment.end, wrapped.end);
+                if (op != '+')
+                    addEpsilon(wrapped.start, wrapped.end);
+                if (op != '?')
+                    addEpsilon(fragment.end, fragment.start);
+                fragment = wrapped;
+            }
+            return fragment;
+        }
+
+        Fragment atom() {
+            if (atEnd()) {
+                error = "Неожиданный конец выражения";
+                return epsilonFragment();
+            }
+            QChar symbol = pattern[position++];
+            if (symbol == '(') {
+                Fragment inner = alternation();
+                if (atEnd() || peek() != ')')
+                    error = "Не закрыта скобка '('";
+                else
+                    ++position;
+                return inner;
+            }
+            if (symbol == '[')
+                return characterClass();
+            if (symbol == '.')
+                return symbolSet(QList<bool>(alphabet.size(), true));
+            if (symbol == '*' || symbol == '+' || symbol == '?' || symbol == ')') {
+                error = QString("Неожиданный символ '%1' в позиции %2").arg(symbol).arg(position);
+                return epsilonFragment();
+            }
+            if (symbol == '\\') {
+                if (atEnd()) {
+                    error = "Выражение оканчивается на '\\'";
+                    return epsilonFragment();
+                }
+                symbol = pattern[position++];
+            }
+            QList<bool> set(alphabet.size(), false);
+            if (alphabet.indexOf(symbol) >= 0)
+                set[alphabet.indexOf(symbol)] = true;
+            return symbolSet(set);
+        }
+
+        Fragment characterClass() {
+            bool negated = !atEnd() && peek() == '^';
+            if (negated)
+                ++position;
+            QList<bool> set(alphabet.size(), false);
+            while (!atEnd() && peek() != ']') {
+                QChar symbol = pattern[position++];
+                if (symbol == '\\' && !atEnd())
+                    symbol = pattern[position++];
+                if (alphabet.indexOf(symbol) >= 0)
+                    set[alphabet.indexOf(symbol)] = true;
+            }
+            if (atEnd()) {
+                error = "Не закрыта скобка '['";
+                return epsilonFragment();
+            }
+            ++position;
+            if (negated)
+                for (int i = 0; i < set.size(); ++i)
+                    set[i] = !set[i];
+            return symbolSet(set);
+        }
+    };
+
+    void epsilonClosure(const std::vector<std::vector<NfaEdge>>& states, std::set<int>& set) {
+        std::vector<int> stack(set.begin(), set.end());
+        while (!stack.empty()) {
+            int state = stack.back();
+            stack.pop_back();
+            for (const NfaEdge& edge : states[state])
+                if (edge.epsilon && set.insert(edge.target).second)
+                    stack.push_back(edge.target);
+        }
+    }
+}
+
+bool Dfa::fromRegex(const QString &pattern, const QString &alphabet, Dfa &dfa, QString &error)
+{
+    bool complemented = pattern.startsWith(QChar('!'));
+    // Разборщик хранит ссылку на выражение, поэтому оно не должно быть временным.
+    const QString body = complemented ? pattern.mid(1) : pattern;
+    RegexParser parser(body, alphabet);
+    Fragment fragment;
+    if (!parser.parse(fragment)) {
+        error = parser.error;
+        return false;
+    }
+
+    // Построение подмножеств; пустое множество становится поглощающим
+    // состоянием, так что автомат получается полным.
+    dfa = Dfa();
+    dfa.symbols = alphabet;
+    std::set<int> initial{fragment.start};
+    epsilonClosure(parser.states, initial);
+    QMap<std::set<int>, int> ids;
+    std::vector<std::set<int>> subsets{initial};
+    ids.insert(initial, 0);
+    for (size_t index = 0; index < subsets.size(); ++index) {
+        std::set<int> subset = subsets[index];
+        dfa.accepting.append(subset.count(fragment.end) > 0);
+        for (int symbol = 0; symbol < alphabet.size(); ++symbol) {
+            std::set<int> target;
+            for (int state : subset)
+                for (const NfaEdge& edge : parser.states[state])
+                    if (!edge.epsilon && edge.symbols[symbol])
+                        target.insert(edge.target);
+            epsilonClosure(parser.states, target);
+            if (!ids.contains(target)) {
+                ids.insert(target, int(subsets.size()));
+                subsets.push_back(target);
+            }
+            dfa.transitions.append(ids.value(target));
+        }
+    }
+
+    if (complemented)
+        dfa.complement();
+    return true;
+}
+
+int Dfa::next(int state, QChar symbol) const
+{
+    int index = symbols.indexOf(symbol);
+    return index < 0 ? -1 : nextByIndex(state, index);
+}
+
+bool Dfa::accepts(const QString &word) const
+{
+    int state = start();
+    for (QChar symbol : word) {
+        state = next(state, symbol);
+        if (state < 0)
+            return false;
+    }
+    return accepting[state];
+}
+
+void Dfa::complement()
+{
+    for (int state = 0; state < accepting.size(); ++state)
+        accepting[state] = !accepting[state];
+}
+
+QList<bool> Dfa::liveStates() const
+{
+    QList<bool> live = accepting;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int state = 0; state < stateCount(); ++state) {
+            if (live[state])
+                continue;
+            for (int symbol = 0; symbol < symbols.size() && !live[state]; ++symbol)
+                live[state] = live[nextByIndex(state, symbol)];
+            changed |= live[state];
+        }
+    }
+    return live;
+}
@@ -0,0 +1,37 @@
+#ifndef DFA_H
+#define DFA_H
+
+#include <QList>
+#include <QString>
+
+// Полный детерминированный автомат над алфавитом терминалов грамматики.
+//
+// Строится из простого регулярного выражения, которое должно совпасть со
+// всей цепочкой: символы, '.', классы [abc] и [^abc], группы, '|', '*',
+// '+', '?', экранирование '\'. Ведущий '!' дополняет язык выражения
+// («!.*aa.*» — цепочки без подцепочки aa).
+class Dfa
+{
+public:
+    static bool fromRegex(const QString& pattern, const QString& alphabet, Dfa& dfa, QString& error);
+
+    const QString& alphabet() const { return symbols; }
+    int stateCount() const { return accepting.size(); }
+    int start() const { return 0; }
+    bool isAccepting(int state) const { return accepting[state]; }
+    // -1, если символа нет в алфавите.
+    int next(int state, QChar symbol) const;
+    int nextByIndex(int state, int symbol) const { return transitions[state * symbols.size() + symbol]; }
+    bool accepts(const QString& word) const;
+
+    void complement();
+    // Состояния, из которых достижимо допускающее; остальные — тупиковые.
+    QList<bool> liveStates() const;
+
+private:
+    QString symbols;
+    QList<int> transitions;     // stateCount × |alphabet|
+    QList<bool> accepting;
+};
+
+#endif // DFA_H
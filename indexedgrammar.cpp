@@ -0,0 +1,164 @@
+#include "indexedgrammar.h"
+
+#include <algorithm>
+
+namespace Grammars {
+
+IndexedGrammar IndexedGrammar::fromCFG(const CFG &cfg)
+{
+    IndexedGrammar grammar;
+    QStringList terminals;
+    for (QChar it : cfg.terminals)
+        terminals.append(QString(it));
+    QStringList nonterminals;
+    for (QChar it : cfg.nonterminals)
+        nonterminals.append(QString(it));
+    grammar.setTerminals(terminals);
+    grammar.setNonterminals(nonterminals);
+    grammar.start = grammar.addNonterminal(QString(cfg.startSymbol), false);
+
+    for (auto it = cfg.rules.begin(); it != cfg.rules.end(); ++it) {
+        for (const QString& rule : it.value()) {
+            if (rule == "λ") {
+                if (it.key() == cfg.startSymbol)
+                    grammar.acceptsEmpty = true;
+                continue;
+            }
+            QStringList symbols;
+            for (QChar symbol : rule)
+                symbols.append(QString(symbol));
+            grammar.addRule(QString(it.key()), symbols);
+        }
+    }
+    grammar.finish();
+    return grammar;
+}
+
+IndexedGrammar IndexedGrammar::fromHomskiy(const Homskiy &homskiy)
+{
+    IndexedGrammar grammar;
+    grammar.setTerminals(QStringList(homskiy.terminals.begin(), homskiy.terminals.end()));
+    grammar.setNonterminals(QStringList(homskiy.nonterminals.begin(), homskiy.nonterminals.end()));
+    grammar.start = grammar.addNonterminal(homskiy.startSymbol, false);
+
+    for (auto it = homskiy.rules.begin(); it != homskiy.rules.end(); ++it) {
+        for (const QStringList& rule : it.value()) {
+            if (rule == QStringList{"λ"}) {
+                if (it.key() == homskiy.startSymbol)
+                    grammar.acceptsEmpty = true;
+                continue;
+            }
+            grammar.addRule(it.key(), rule);
+        }
+    }
+    grammar.finish();
+    return grammar;
+}
+
+bool IndexedGrammar::toTerminals(const QString &word, QList<int> &out) const
+{
+    out.clear();
+    out.reserve(word.length());
+    for (QChar symbol : word) {
+        int terminal = terminalIndex(symbol);
+        if (terminal < 0)
+            return false;
+        out.append(terminal);
+    }
+    return true;
+}
+
+QString IndexedGrammar::fromTerminals(const QList<int> &word) const
+{
+    QString result;
+    result.reserve(word.size());
+    for (int terminal : word)
+        result += terminals[terminal];
+    return result;
+}
+
+int IndexedGrammar::addNonterminal(const QString &name, bool isSynthetic)
+{
+    auto it = nonterminalIds.constFind(name);
+    if (it != nonterminalIds.constEnd())
+        return it.value();
+    int id = nonterminals.size();
+    nonterminals.append(name);
+    synthetic.append(isSynthetic);
+    nonterminalIds.insert(name, id);
+    return id;
+}
+
+int IndexedGrammar::preterminal(int terminal)
+{
+    if (preterminalIds[terminal] >= 0)
+        return preterminalIds[terminal];
+    QString name = "<" + terminals[terminal] + ">";
+    while (nonterminalIds.contains(name))
+        name += "'";
+    int id = addNonterminal(name, true);
+    unary.append({id, terminal});
+    preterminalIds[terminal] = id;
+    return id;
+}
+
+void IndexedGrammar::setTerminals(QStringList symbols)
+{
+    // Порядок терминалов совпадает с порядком QString, поэтому сравнение
+    // индексов даёт лексикографический порядок цепочек.
+    std::sort(symbols.begin(), symbols.end());
+    terminals = symbols;
+    for (int i = 0; i < terminals.size(); ++i)
+        terminalIds.insert(terminals[i].at(0), i);
+    preterminalIds = QList<int>(terminals.size(), -1);
+}
+
+void IndexedGrammar::setNonterminals(QStringList symbols)
+{
+    std::sort(symbols.begin(), symbols.end());
+    for (const QString& symbol : symbols)
+        addNonterminal(symbol, false);
+}
+
+void IndexedGrammar::addRule(const QString &lhs, const QStringList &rhs)
+{
+    int key = addNonterminal(lhs, false);
+    auto isTerminal = [this](const QString& symbol) {
+        return symbol.length() == 1 && terminalIds.contains(symbol.at(0)) && !nonterminalIds.contains(symbol);
+    };
+
+    if (rhs.size() == 1) {
+        // Цепные правила A -> B приведённая грамматика не содержит.
+        if (isTerminal(rhs[0]))
+            unary.append({key, terminalIds.value(rhs[0].at(0))});
+        else if (rhs[0] == lhs && !selfLoops.contains(key))
+            selfLoops.append(key);
+        return;
+    }
+    if (rhs.size() < 2)
+        return;
+
+    QList<int> symbols;
+    for (const QString& symbol : rhs)
+        symbols.append(isTerminal(symbol) ? preterminal(terminalIds.value(symbol.at(0))) : addNonterminal(symbol, false));
+
+    int current = key;
+    for (int i = 0; i + 2 < symbols.size(); ++i) {
+        int next = addNonterminal(QString("%1#%2.%3").arg(lhs).arg(binary.size()).arg(i), true);
+        binary.append({current, symbols[i], next});
+        current = next;
+    }
+    binary.append({current, symbols[symbols.size() - 2], symbols.last()});
+}
+
+void IndexedGrammar::finish()
+{
+    binaryByLhs = QList<QList<int>>(nonterminals.size());
+    unaryByLhs = QList<QList<int>>(nonterminals.size());
+    for (int i = 0; i < binary.size(); ++i)
+        binaryByLhs[binary[i].lhs].append(i);
+    for (int i = 0; i < unary.size(); ++i)
+        unaryByLhs[unary[i].lhs].append(i);
+}
+
+}
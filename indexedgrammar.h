@@ -0,0 +1,63 @@
+#ifndef INDEXEDGRAMMAR_H
+#define INDEXEDGRAMMAR_H
+
+#include "mainwindow.h"
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+namespace Grammars {
+    // Грамматика в бинарной нормальной форме с целочисленными символами.
+    // Правила вида A -> BC и A -> t; длинные правила КС-грамматики разбиваются
+    // на цепочки служебных (synthetic) нетерминалов, которые при выводе деревьев
+    // сворачиваются обратно в исходное правило.
+    struct IndexedGrammar {
+        struct Binary {
+            int lhs;
+            int left;
+            int right;
+        };
+
+        struct Unary {
+            int lhs;
+            int terminal;
+        };
+
+        QStringList nonterminals;
+        QList<bool> synthetic;
+        QStringList terminals;
+        QList<Binary> binary;
+        QList<Unary> unary;
+        QList<QList<int>> binaryByLhs;
+        QList<QList<int>> unaryByLhs;
+        // Нетерминалы с петлёй A -> A: в таблицы она не входит, так как язык
+        // не меняет, но даёт каждой цепочке через A бесконечно много выводов.
+        QList<int> selfLoops;
+        int start = -1;
+        bool acceptsEmpty = false;
+
+        static IndexedGrammar fromCFG(const CFG& cfg);
+        static IndexedGrammar fromHomskiy(const Homskiy& homskiy);
+
+        int nonterminalIndex(const QString& name) const { return nonterminalIds.value(name, -1); }
+        int terminalIndex(QChar symbol) const { return terminalIds.value(symbol, -1); }
+        bool toTerminals(const QString& word, QList<int>& out) const;
+        QString fromTerminals(const QList<int>& word) const;
+
+    private:
+        QHash<QString, int> nonterminalIds;
+        QHash<QChar, int> terminalIds;
+        QList<int> preterminalIds;
+
+        int addNonterminal(const QString& name, bool isSynthetic);
+        int preterminal(int terminal);
+        void setTerminals(QStringList symbols);
+        void setNonterminals(QStringList symbols);
+        void addRule(const QString& lhs, const QStringList& rhs);
+        void finish();
+    };
+}
+
+#endif // INDEXEDGRAMMAR_H
@@ -0,0 +1,362 @@
+#include "lrtable.h"
+#include "profiler.h"
+
+#include <QSet>
+#include <algorithm>
+#include <map>
+#include <set>
+
+namespace {
+    struct Item {
+        int production;
+        int dot;
+        int lookahead;
+
+        bool operator<(const Item& other) const {
+            if (production != other.production)
+                return production < other.production;
+            if (dot != other.dot)
+                return dot < other.dot;
+            return lookahead < other.lookahead;
+        }
+        bool operator==(const Item& other) const {
+            return production == other.production && dot == other.dot && lookahead == other.lookahead;
+        }
+    };
+}
+
+LrTable::LrTable(const Grammars::CFG &cfg)
+{
+    PROFILE_SCOPE("LrTable::build");
+    QList<QChar> terminalList(cfg.terminals.begin(), cfg.terminals.end());
+    QSet<QChar> nonterminalSet = cfg.nonterminals;
+    for (auto it = cfg.rules.begin(); it != cfg.rules.end(); ++it)
+        nonterminalSet.insert(it.key());
+    for (auto it = cfg.rules.begin(); it != cfg.rules.end(); ++it)
+        for (const QString& rule : it.value())
+            for (QChar symbol : rule)
+                if (rule != "λ" && !nonterminalSet.contains(symbol) && !terminalList.contains(symbol))
+                    terminalList.append(symbol);
+    std::sort(terminalList.begin(), terminalList.end());
+    for (QChar symbol : terminalList)
+        terminals += symbol;
+    terminalCount = terminals.size();
+
+    nonterminals = QList<QChar>(nonterminalSet.begin(), nonterminalSet.end());
+    std::sort(nonterminals.begin(), nonterminals.end());
+    nonterminals.append(QChar());
+
+    std::fill(std::begin(asciiTerminals), std::end(asciiTerminals), -1);
+    for (int t = 0; t < terminalCount; ++t)
+        if (terminals[t].unicode() < 128)
+            asciiTerminals[terminals[t].unicode()] = t;
+
+    auto symbolIndex = [this](QChar symbol) {
+        int nonterminal = nonterminals.indexOf(symbol);
+        return nonterminal >= 0 ? terminalCount + 1 + nonterminal : int(terminals.indexOf(symbol));
+    };
+    int augmented = nonterminals.size() - 1;
+    productions.push_back({augmented, {symbolIndex(cfg.startSymbol)}});
+    for (auto it = cfg.rules.begin(); it != cfg.rules.end(); ++it) {
+        for (const QString& rule : it.value()) {
+            Production production{int(nonterminals.indexOf(it.key())), {}};
+            if (rule != "λ")
+                for (QChar symbol : rule)
+                    production.rhs.push_back(symbolIndex(symbol));
+            productions.push_back(production);
+        }
+    }
+    build();
+}
+
+void LrTable::build()
+{
+    const int nonterminalCount = nonterminals.size();
+    std::vector<std::vector<int>> byLhs(nonterminalCount);
+    for (int p = 0; p < int(productions.size()); ++p)
+        byLhs[productions[p].lhs].push_back(p);
+
+    // FIRST и ε-порождаемость нетерминалов.
+    std::vector<bool> nullable(nonterminalCount, false);
+    std::vector<std::set<int>> first(nonterminalCount);
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (const Production& production : productions) {
+            bool allNullable = true;
+            for (int symbol : production.rhs) {
+                if (!isNonterminal(symbol)) {
+                    changed |= first[production.lhs].insert(symbol).second;
+                    allNullable = false;
+                    break;
+                }
+                int nonterminal = symbol - terminalCount - 1;
+                for (int terminal : first[nonterminal])
+                    changed |= first[production.lhs].insert(terminal).second;
+                if (!nullable[nonterminal]) {
+                    allNullable = false;
+                    break;
+                }
+            }
+            if (allNullable && !nullable[production.lhs]) {
+                nullable[production.lhs] = true;
+                changed = true;
+            }
+        }
+    }
+
+    auto closure = [&](std::vector<Item> items) {
+        std::set<Item> result(items.begin(), items.end());
+        while (!items.empty()) {
+            Item item = items.back();
+            items.pop_back();
+            const std::vector<int>& rhs = productions[item.production].rhs;
+            if (item.dot >= int(rhs.size()) || !isNonterminal(rhs[item.dot]))
+                continue;
+
+            // FIRST(βa) для пункта [A -> α·Bβ, a].
+            std::set<int> lookaheads;
+            bool allNullable = true;
+            for (size_t i = item.dot + 1; i < rhs.size() && allNullable; ++i) {
+                if (!isNonterminal(rhs[i])) {
+                    lookaheads.insert(rhs[i]);
+                    allNullable = false;
+                } else {
+                    int nonterminal = rhs[i] - terminalCount - 1;
+                    lookaheads.insert(first[nonterminal].begin(), first[nonterminal].end());
+                    allNullable = nullable[nonterminal];
+                }
+            }
+            if (allNullable)
+                lookaheads.insert(item.lookahead);
+
+            for (int p : byLhs[rhs[item.dot] - terminalCount - 1]) {
+                for (int lookahead : lookaheads) {
+                    Item next{p, 0, lookahead};
+                    if (result.insert(next).second)
+                        items.push_back(next);
+                }
+            }
+        }
+        return std::vector<Item>(result.begin(), result.end());
+    };
+
+    // Канонический автомат LR(1): состояние определяется своим ядром.
+    std::vector<std::vector<Item>> closures;
+    std::vector<std::map<int, int>> transitions;
+    std::map<std::vector<Item>, int> stateIds;
+    std::vector<std::vector<Item>> kernels{{Item{0, 0, endSymbol()}}};
+    stateIds[kernels[0]] = 0;
+    for (size_t state = 0; state < kernels.size(); ++state) {
+        closures.push_back(closure(kernels[state]));
+        std::map<int, std::vector<Item>> moves;
+        for (const Item& item : closures[state]) {
+            const std::vector<int>& rhs = productions[item.production].rhs;
+            if (item.dot < int(rhs.size()))
+                moves[rhs[item.dot]].push_back({item.production, item.dot + 1, item.lookahead});
+        }
+        transitions.emplace_back();
+        for (auto& [symbol, kernel] : moves) {
+            std::sort(kernel.begin(), kernel.end());
+            kernel.erase(std::unique(kernel.begin(), kernel.end()), kernel.end());
+            auto inserted = stateIds.emplace(kernel, int(kernels.size()));
+            if (inserted.second)
+                kernels.push_back(kernel);
+            transitions[state][symbol] = inserted.first->second;
+        }
+    }
+
+    // Слияние состояний с одинаковым ядром (без предпросмотра) даёт LALR(1).
+    std::map<std::vector<std::pair<int, int>>, int> coreIds;
+    std::vector<int> merged(kernels.size());
+    for (size_t state = 0; state < kernels.size(); ++state) {
+        std::vector<std::pair<int, int>> core;
+        for (const Item& item : kernels[state])
+            core.emplace_back(item.production, item.dot);
+        core.erase(std::unique(core.begin(), core.end()), core.end());
+        merged[state] = coreIds.emplace(core, int(coreIds.size())).first->second;
+    }
+    states = int(coreIds.size());
+
+    action.assign(size_t(states) * (terminalCount + 1), 0);
+    gotoTable.assign(size_t(states) * nonterminalCount, -1);
+    for (size_t state = 0; state < kernels.size(); ++state) {
+        int target = merged[state];
+        for (const auto& [symbol, next] : transitions[state]) {
+            if (isNonterminal(symbol))
+                gotoTable[size_t(target) * nonterminalCount + symbol - terminalCount - 1] = merged[next];
+            else
+                setAction(target, symbol, merged[next] + 1);
+        }
+        for (const Item& item : closures[state])
+            if (item.dot == int(productions[item.production].rhs.size()))
+                setAction(target, item.lookahead, -(item.production + 1));
+    }
+}
+
+void LrTable::setAction(int state, int terminal, int value)
+{
+    int& current = action[size_t(state) * (terminalCount + 1) + terminal];
+    if (current == 0 || current == value) {
+        current = value;
+        return;
+    }
+
+    ConflictKind kind = current > 0 || value > 0 ? ShiftReduce : ReduceReduce;
+    int shift = std::max(current, value);
+    int reduce = std::min(current, value);
+    QChar lookahead = terminal == endSymbol() ? QChar() : terminals[terminal];
+    for (const Conflict& conflict : conflictList)
+        if (conflict.state == state && conflict.lookahead == lookahead && conflict.kind == kind)
+            return;
+
+    QString symbol = terminal == endSymbol() ? QString("конец цепочки") : QString("'%1'").arg(terminals[terminal]);
+    QString description = kind == ShiftReduce
+        ? QString("состояние %1, %2: сдвиг/свёртка по %3").arg(state).arg(symbol).arg(productionText(-reduce - 1))
+        : QString("состояние %1, %2: свёртка/свёртка по %3 и %4").arg(state).arg(symbol)
+              .arg(productionText(-shift - 1)).arg(productionText(-reduce - 1));
+    conflictList.append({state, lookahead, kind, description});
+    // Как в yacc: сдвиг важнее свёртки, из свёрток — правило с меньшим номером.
+    current = shift;
+}
+
+QString LrTable::symbolName(int symbol) const
+{
+    if (!isNonterminal(symbol))
+        return QString(terminals[symbol]);
+    int nonterminal = symbol - terminalCount - 1;
+    return nonterminal == nonterminals.size() - 1 ? QString("S'") : QString(nonterminals[nonterminal]);
+}
+
+QString LrTable::productionText(int production) const
+{
+    const Production& p = productions[production];
+    QString rhs;
+    for (int symbol : p.rhs)
+        rhs += symbolName(symbol);
+    return symbolName(terminalCount + 1 + p.lhs) + "→" + (rhs.isEmpty() ? QString("λ") : rhs);
+}
+
+template<typename Next>
+bool LrTable::run(Next &&next, std::vector<int> &stack) const
+{
+    const int nonterminalCount = nonterminals.size();
+    stack.clear();
+    stack.push_back(0);
+    int terminal = next();
+    while (terminal >= 0) {
+        int value = action[size_t(stack.back()) * (terminalCount + 1) + terminal];
+        if (value > 0) {
+            stack.push_back(value - 1);
+            terminal = next();
+        } else if (value == -1) {
+            return true;
+        } else if (value == 0) {
+            return false;
+        } else {
+            const Production& production = productions[-value - 1];
+            stack.resize(stack.size() - production.rhs.size());
+            stack.push_back(gotoTable[size_t(stack.back()) * nonterminalCount + production.lhs]);
+        }
+    }
+    return false;
+}
+
+bool LrTable::accepts(QStringView word) const
+{
+    std::vector<int> stack;
+    return accepts(word, stack);
+}
+
+bool LrTable::accepts(QStringView word, std::vector<int> &stack) const
+{
+    qsizetype position = 0;
+    return run([&]() -> int {
+        if (position == word.size())
+            return endSymbol();
+        QChar symbol = word[position++];
+        return symbol.unicode() < 128 ? asciiTerminals[symbol.unicode()] : int(terminals.indexOf(symbol));
+    }, stack);
+}
+
+bool LrTable::acceptsUtf8(const char *data, int size, std::vector<int> &stack) const
+{
+    for (int i = 0; i < size; ++i)
+        if (static_cast<unsigned char>(data[i]) >= 128)
+            return accepts(QString::fromUtf8(data, size), stack);
+    int position = 0;
+    return run([&]() -> int {
+        return position == size ? endSymbol() : asciiTerminals[static_cast<unsigned char>(data[position++])];
+    }, stack);
+}
+
+QString LrTable::toCppHeader(const QString &namespaceName) const
+{
+    const int nonterminalCount = nonterminals.size();
+    QString text;
+    text += "// Сгенерировано TPLHomskiy: LALR(1)-таблицы грамматики.\n";
+    text += "// action: 0 — ошибка, s + 1 — сдвиг в s, -(p + 1) — свёртка по p, -1 — допуск.\n";
+    text += "#pragma once\n\n#include <string_view>\n#include <vector>\n\n";
+    text += QString("namespace %1 {\n\n").arg(namespaceName);
+
+    QString escaped;
+    for (QChar symbol : terminals)
+        escaped += QString("\\u%1").arg(int(symbol.unicode()), 4, 16, QChar('0'));
+    text += QString("constexpr char16_t terminals[] = u\"%1\";\n").arg(escaped);
+    text += QString("constexpr int terminalCount = %1;\n").arg(terminalCount);
+    text += QString("constexpr int nonterminalCount = %1;\n").arg(nonterminalCount);
+    text += QString("constexpr int stateCount = %1;\n").arg(states);
+    text += QString("constexpr int productionCount = %1;\n\n").arg(int(productions.size()));
+
+    auto table = [&](const char* declaration, const std::vector<int>& values, int columns) {
+        text += QString("constexpr int %1 = {\n").arg(declaration);
+        for (int state = 0; state < states; ++state) {
+            QStringList row;
+            for (int column = 0; column < columns; ++column)
+                row.append(QString::number(values[size_t(state) * columns + column]));
+            text += "    {" + row.join(", ") + "},\n";
+        }
+        text += "};\n";
+    };
+    table("actionTable[stateCount][terminalCount + 1]", action, terminalCount + 1);
+    table("gotoTable[stateCount][nonterminalCount]", gotoTable, nonterminalCount);
+
+    QStringList lhs, lengths;
+    for (size_t p = 0; p < productions.size(); ++p) {
+        lhs.append(QString::number(productions[p].lhs));
+        lengths.append(QString::number(int(productions[p].rhs.size())));
+        text += QString("// %1: %2\n").arg(int(p)).arg(productionText(int(p)));
+    }
+    text += QString("constexpr int productionLhs[productionCount] = {%1};\n").arg(lhs.join(", "));
+    text += QString("constexpr int productionLength[productionCount] = {%1};\n\n").arg(lengths.join(", "));
+
+    text +=
+        "inline bool accepts(std::u16string_view word)\n"
+        "{\n"
+        "    std::vector<int> stack{0};\n"
+        "    size_t position = 0;\n"
+        "    for (;;) {\n"
+        "        int terminal = terminalCount;\n"
+        "        if (position < word.size()) {\n"
+        "            size_t index = std::u16string_view(terminals).find(word[position]);\n"
+        "            if (index == std::u16string_view::npos)\n"
+        "                return false;\n"
+        "            terminal = int(index);\n"
+        "        }\n"
+        "        int action = actionTable[stack.back()][terminal];\n"
+        "        if (action > 0) {\n"
+        "            stack.push_back(action - 1);\n"
+        "            ++position;\n"
+        "        } else if (action == -1) {\n"
+        "            return true;\n"
+        "        } else if (action == 0) {\n"
+        "            return false;\n"
+        "        } else {\n"
+        "            stack.resize(stack.size() - productionLength[-action - 1]);\n"
+        "            stack.push_back(gotoTable[stack.back()][productionLhs[-action - 1]]);\n"
+        "        }\n"
+        "    }\n"
+        "}\n\n";
+    text += QString("} // namespace %1\n").arg(namespaceName);
+    return text;
+}
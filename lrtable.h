@@ -0,0 +1,75 @@
+#ifndef LRTABLE_H
+#define LRTABLE_H
+
+#include "mainwindow.h"
+
+#include <QList>
+#include <QString>
+#include <QStringView>
+#include <vector>
+
+// Таблицы LALR(1) для КС-грамматики: канонический автомат LR(1), состояния
+// которого с одинаковым ядром затем сливаются. Для грамматики без конфликтов
+// разбор идёт за линейное время; при конфликтах таблица всё равно строится
+// (сдвиг предпочитается свёртке, свёртка — по правилу с меньшим номером),
+// но вызывающий код должен вернуться к общим методам (CYK).
+class LrTable
+{
+public:
+    enum ConflictKind {
+        ShiftReduce,
+        ReduceReduce
+    };
+
+    struct Conflict {
+        int state;
+        QChar lookahead;        // нулевой QChar — конец цепочки
+        ConflictKind kind;
+        QString description;
+    };
+
+    explicit LrTable(const Grammars::CFG& cfg);
+
+    bool hasConflicts() const { return !conflictList.isEmpty(); }
+    const QList<Conflict>& conflicts() const { return conflictList; }
+    int stateCount() const { return states; }
+    int productionCount() const { return static_cast<int>(productions.size()); }
+    QString productionText(int production) const;
+
+    bool accepts(QStringView word) const;
+    // Стек передаётся снаружи, чтобы один экземпляр таблицы можно было
+    // использовать из нескольких потоков.
+    bool accepts(QStringView word, std::vector<int>& stack) const;
+    bool acceptsUtf8(const char* data, int size, std::vector<int>& stack) const;
+
+    // Заголовок C++ с таблицами в constexpr-массивах и функцией accepts().
+    QString toCppHeader(const QString& namespaceName) const;
+
+private:
+    struct Production {
+        int lhs;
+        std::vector<int> rhs;   // терминал < terminalCount, нетерминал n — terminalCount + 1 + n
+    };
+
+    QString terminals;
+    QList<QChar> nonterminals;  // последний — добавленный стартовый S'
+    std::vector<Production> productions;
+    int terminalCount = 0;
+    int states = 0;
+    int asciiTerminals[128];
+
+    // action: 0 — ошибка, s + 1 — сдвиг в s, -(p + 1) — свёртка по p, -1 — допуск.
+    std::vector<int> action;
+    std::vector<int> gotoTable;
+    QList<Conflict> conflictList;
+
+    int endSymbol() const { return terminalCount; }
+    bool isNonterminal(int symbol) const { return symbol > terminalCount; }
+    QString symbolName(int symbol) const;
+    void build();
+    void setAction(int state, int terminal, int value);
+    template<typename Next>
+    bool run(Next&& next, std::vector<int>& stack) const;
+};
+
+#endif // LRTABLE_H
@@ -1,9 +1,15 @@
 #include "mainwindow.h"
+#include "cli.h"
 
 #include <QApplication>
+#include <QCoreApplication>
 
 int main(int argc, char *argv[])
 {
+    if (isCliInvocation(argc, argv)) {
+        QCoreApplication a(argc, argv);
+        return runCli(a.arguments());
+    }
     QApplication a(argc, argv);
     MainWindow w;
     w.show();
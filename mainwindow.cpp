@@ -1,6 +1,15 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
 #include "chaintreedialog.h"
+#include "chainmodal.h"
+#include "chaincache.h"
+#include "productgrammar.h"
+#include "resultcache.h"
+#include "worditerator.h"
+#include "shortestwords.h"
+#include "cykparser.h"
+#include "ambiguity.h"
+#include "profiler.h"
 
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -16,16 +25,33 @@
 #include <QInputDialog>
 #include <QMessageBox>
 #include <QStandardItemModel>
+#include <QCoreApplication>
+#include <QEventLoop>
+#include <QProgressDialog>
+#include <QThreadPool>
+#include <QTimer>
+#include <atomic>
+
+// Выше этого числа цепочек списки строятся постранично через ChainCounter.
+static const quint64 kMaxMaterializedChains = 5000;
+static const int kPageSize = 200;
+static const int kPreviewSize = 10;
+// Предел потокового сравнения языков в постраничном режиме.
+static const quint64 kMaxComparedChains = 100000;
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
+    , resultCache(std::make_shared<ResultCache>())
 {
     ui->setupUi(this);
     connect(ui->loadConfigurationButton, &QPushButton::clicked, this, &MainWindow::onLoadConfiguration);
     connect(ui->calculateHomskiy, &QPushButton::clicked, this, &MainWindow::onCalculateHomskiy);
     connect(ui->showChains, &QPushButton::clicked, this, &MainWindow::onShowChains);
     connect(ui->checkEqualButton, &QPushButton::clicked, this, &MainWindow::onCheckEqual);
+    connect(ui->checkAmbiguityButton, &QPushButton::clicked, this, &MainWindow::onCheckAmbiguity);
+    connect(ui->prevPage, &QPushButton::clicked, this, &MainWindow::onPrevPage);
+    connect(ui->nextPage, &QPushButton::clicked, this, &MainWindow::onNextPage);
 
     ui->listCFG->setEditTriggers(QAbstractItemView::DoubleClicked);
     ui->listCFG->setContextMenuPolicy(Qt::CustomContextMenu);
@@ -43,12 +69,25 @@ MainWindow::MainWindow(QWidget *parent)
     ui->showChains->hide();
     ui->left->hide();
     ui->right->hide();
+    ui->filterEdit->hide();
     ui->listCFG->hide();
     ui->listHomskiy->hide();
     ui->checkEqualButton->hide();
+    ui->checkAmbiguityButton->hide();
+    hidePaging();
+
+#ifdef TPL_PROFILING
+    QMenu *profilingMenu = ui->menubar->addMenu("Профилирование");
+    connect(profilingMenu->addAction("Экспорт трассировки..."), &QAction::triggered, this, &MainWindow::onExportTrace);
+    connect(profilingMenu->addAction("Сбросить"), &QAction::triggered, this, [this]() {
+        Profiler::reset();
+        updateProfileStatus();
+    });
+#endif
 }
 
 Grammars::CFG parseCFGFromJson(const QString& filePath) {
+    PROFILE_SCOPE("parseCFGFromJson");
 
     QFile file(filePath);
 
@@ -232,34 +271,38 @@ bool hasUnattainable(const Grammars::CFG &cfg){
     return !(symbols.size() == (cfg.nonterminals.size() + cfg.terminals.size()));
 }
 
-bool MainWindow::checkCanon(const Grammars::CFG &cfg)
+QString canonError(const Grammars::CFG &cfg)
 {
+    PROFILE_SCOPE("checkCanon");
     if (!termsAndNontermsIsDifferent(cfg)){
-        ui->errorLabel->setText("Терминал содержится в нетерменалах или наоборот");
-        return false;
+        return "Терминал содержится в нетерменалах или наоборот";
     }
     if (!isValidSymbolsInRules(cfg)){
-        ui->errorLabel->setText("Правила КС-грамматики содержат невозможные символы");
-        return false;
+        return "Правила КС-грамматики содержат невозможные символы";
     }
     if (!isValidKeysInRules(cfg)){
-        ui->errorLabel->setText("Ключи правил КС-грамматики содержат невозможные символы");
-        return false;
+        return "Ключи правил КС-грамматики содержат невозможные символы";
     }
     if (hasLambdas(cfg)){
-        ui->errorLabel->setText("Правила КС-грамматики содержат λ");
-        return false;
+        return "Правила КС-грамматики содержат λ";
     }
     if (hasCicles(cfg)){
-        ui->errorLabel->setText("Правила КС-грамматики содержат циклы");
-        return false;
+        return "Правила КС-грамматики содержат циклы";
     }
     if (hasUseless(cfg)){
-        ui->errorLabel->setText("КС-грамматика содержат бесполезные нетерминалы");
-        return false;
+        return "КС-грамматика содержат бесполезные нетерминалы";
     }
     if (hasUnattainable(cfg)){
-        ui->errorLabel->setText("КС-грамматика содержат недостижимые символы");
+        return "КС-грамматика содержат недостижимые символы";
+    }
+    return {};
+}
+
+bool MainWindow::checkCanon(const Grammars::CFG &cfg)
+{
+    QString error = canonError(cfg);
+    if (!error.isEmpty()){
+        ui->errorLabel->setText(error);
         return false;
     }
     return true;
@@ -267,10 +310,13 @@ bool MainWindow::checkCanon(const Grammars::CFG &cfg)
 
 void insertRuleIntoHomskyGrammar(Grammars::Homskiy &homsky, const QString& key, const QStringList& rule){
     if (homsky.rules.contains(key)){
-        if (!homsky.rules[key].contains(rule))
+        if (!homsky.rules[key].contains(rule)){
+            PROFILE_COUNT(RulesCreated, 1);
             homsky.rules[key].append(rule);
+        }
     }
     else{
+        PROFILE_COUNT(RulesCreated, 1);
         QList<QStringList> list{rule};
         homsky.rules[key] = list;
         homsky.nonterminals.insert(key);
@@ -317,6 +363,7 @@ void homskyStep(Grammars::Homskiy &homskiy, QStringList& rule){
 }
 
 Grammars::Homskiy makeHomskyFromCFG(const Grammars::CFG &cfg){
+    PROFILE_SCOPE("makeHomskyFromCFG");
     Grammars::Homskiy homskiy;
     for(auto it: cfg.terminals)
         homskiy.terminals.insert(QString(it));
@@ -349,7 +396,11 @@ Grammars::Homskiy makeHomskyFromCFG(const Grammars::CFG &cfg){
 
 void MainWindow::translateToHomskiy()
 {
-    homsky = makeHomskyFromCFG(cfg);
+    homsky = resultCache->homskiyFromCFG(cfg);
+    cfgCache.reset();
+    homskiyCache.reset();
+    chainFilter.clear();
+    filterDfa.reset();
 
     QString rules = genGrammar<Grammars::Homskiy>(homsky);
     rules += "\n\n";
@@ -381,6 +432,10 @@ void MainWindow::onLoadConfiguration(){
     }
     ui->calculateHomskiy->show();
     cfg = parseCFGFromJson(filePath);
+    cfgCache.reset();
+    homskiyCache.reset();
+    chainFilter.clear();
+    filterDfa.reset();
     updateUIRules(cfg);
     ui->errorLabel->hide();
     ui->homskiyRules->hide();
@@ -389,9 +444,13 @@ void MainWindow::onLoadConfiguration(){
     ui->showChains->hide();
     ui->left->hide();
     ui->right->hide();
+    ui->filterEdit->hide();
     ui->listCFG->hide();
     ui->listHomskiy->hide();
     ui->checkEqualButton->hide();
+    ui->checkAmbiguityButton->hide();
+    hidePaging();
+    updateProfileStatus();
 }
 
 void MainWindow::onCalculateHomskiy()
@@ -408,36 +467,50 @@ void MainWindow::onCalculateHomskiy()
     ui->showChains->show();
     ui->left->show();
     ui->right->show();
+    ui->filterEdit->show();
     ui->checkEqualButton->hide();
+    ui->checkAmbiguityButton->show();
+    updateProfileStatus();
 }
 
-void displayChainsInListView(const QSet<QStringList>& chains, QStandardItemModel* model) {
+void displayChainsInListView(const QStringList& chains, QStandardItemModel* model) {
+    PROFILE_SCOPE("displayChainsInListView");
     model->clear();
-    QList<QString> sortedChains;
-    for (const QStringList& chain : chains) {
-        sortedChains.append(chain.join(""));
-    }
-    std::sort(sortedChains.begin(), sortedChains.end());
-
-    for (const QString& chain : sortedChains) {
-        QStandardItem *item = new QStandardItem(chain);
+    for (const QString& chain : chains) {
+        QStandardItem *item = new QStandardItem(chain.isEmpty() ? "λ" : chain);
         model->appendRow(item);
     }
 }
 
-void displayChainsInListView(const QSet<QString>& chains, QStandardItemModel* model) {
-    model->clear();
-    QList<QString> sortedChains = chains.values();
-    std::sort(sortedChains.begin(), sortedChains.end());
+bool MainWindow::updateFilter()
+{
+    QString filter = ui->filterEdit->text();
+    if (filter == chainFilter)
+        return true;
 
-    for (const QString& chain : sortedChains) {
-        QStandardItem *item = new QStandardItem(chain);
-        model->appendRow(item);
+    std::shared_ptr<Dfa> dfa;
+    if (!filter.isEmpty()) {
+        QString alphabet;
+        for (const QString& terminal : homsky.terminals)
+            alphabet += terminal;
+        dfa = std::make_shared<Dfa>();
+        QString error;
+        if (!Dfa::fromRegex(filter, alphabet, *dfa, error)) {
+            QMessageBox::warning(this, "Фильтр", "Ошибка в регулярном выражении: " + error);
+            return false;
+        }
     }
+    chainFilter = filter;
+    filterDfa = dfa;
+    cfgCache.reset();
+    homskiyCache.reset();
+    return true;
 }
 
 void MainWindow::onShowChains()
 {
+    if (!updateFilter())
+        return;
     ui->listCFG->show();
     ui->listHomskiy->show();
     QStandardItemModel* modelHomskiy = new QStandardItemModel(this);
@@ -446,20 +519,129 @@ void MainWindow::onShowChains()
     ui->listCFG->setModel(modelCFG);
     ui->listHomskiy->setModel(modelHomskiy);
 
-    QSet<QString> cfgChains;
-    cfg.generateAllChains(ui->left->value(), ui->right->value(), cfgChains, cfgTrees);
-
-    QSet<QStringList> homskiyChains;
-    homsky.generateAllChains(ui->left->value(), ui->right->value(), homskiyChains, homskiyTrees);
+    // С фильтром обе стороны строятся по своему пересечению с автоматом:
+    // подсчёт, страницы и сравнение идут по одним и тем же отфильтрованным языкам.
+    if (!cfgCache) {
+        Grammars::IndexedGrammar grammar = Grammars::IndexedGrammar::fromCFG(cfg);
+        if (filterDfa)
+            grammar = Grammars::IndexedGrammar::fromHomskiy(intersectWithDfa(grammar, *filterDfa));
+        cfgCache = std::make_shared<ChainCache>(grammar);
+        cfgCache->setStore(resultCache.get());
+    }
+    if (!homskiyCache) {
+        homskiyCache = std::make_shared<ChainCache>(Grammars::IndexedGrammar::fromHomskiy(
+            filterDfa ? intersectWithDfa(homsky, *filterDfa) : homsky));
+        homskiyCache->setStore(resultCache.get());
+    }
+
+    // Мгновенный предпросмотр, пока строится полный список.
+    QStringList preview = ShortestWords(homskiyCache->grammar()).shortestWords(kPreviewSize);
+    for (QString& word : preview)
+        if (word.isEmpty())
+            word = "λ";
+    ui->statusbar->showMessage("Кратчайшие цепочки: " + preview.join(", "));
+    QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
+
+    cfgCache->counter().extend(ui->right->value());
+    homskiyCache->counter().extend(ui->right->value());
+    quint64 total = std::max(cfgCache->counter().count(ui->left->value(), ui->right->value()),
+                             homskiyCache->counter().count(ui->left->value(), ui->right->value()));
+    if (total > kMaxMaterializedChains) {
+        pageStart = 0;
+        pageHistory.clear();
+        showPage();
+        ui->checkEqualButton->show();
+        updateProfileStatus();
+        return;
+    }
+    hidePaging();
 
-    displayChainsInListView(cfgChains, modelCFG);
-    displayChainsInListView(homskiyChains, modelHomskiy);
+    displayChainsInListView(cfgCache->words(ui->left->value(), ui->right->value()), modelCFG);
+    displayChainsInListView(homskiyCache->words(ui->left->value(), ui->right->value()), modelHomskiy);
     ui->checkEqualButton->show();
+    updateProfileStatus();
+}
+
+void MainWindow::showPage()
+{
+    int minLength = ui->left->value();
+    int maxLength = ui->right->value();
+    ChainCounter& homskiyCounter = homskiyCache->counter();
+    QStringList homskiyPage = homskiyCounter.page(pageStart, kPageSize, minLength, maxLength);
+    pageFirst = homskiyPage.isEmpty() ? QString() : homskiyPage.first();
+    pageLast = homskiyPage.isEmpty() ? QString() : homskiyPage.last();
+    // Обе страницы начинаются с одной и той же цепочки, чтобы их можно было сравнить.
+    QStringList cfgPage = homskiyPage.isEmpty() ? QStringList()
+                                                : cfgCache->counter().pageFrom(homskiyPage.first(), kPageSize, minLength, maxLength);
+
+    displayChainsInListView(cfgPage, qobject_cast<QStandardItemModel*>(ui->listCFG->model()));
+    displayChainsInListView(homskiyPage, qobject_cast<QStandardItemModel*>(ui->listHomskiy->model()));
+
+    quint64 total = homskiyCounter.count(minLength, maxLength);
+    ui->pageLabel->setText(QString("Страница %1, первая цепочка — вывод №%2 из %3")
+                               .arg(pageHistory.size() + 1).arg(pageStart + 1).arg(total));
+    ui->prevPage->setEnabled(!pageHistory.isEmpty());
+    ui->nextPage->setEnabled(homskiyPage.size() == kPageSize);
+    ui->prevPage->show();
+    ui->pageLabel->show();
+    ui->nextPage->show();
+}
+
+void MainWindow::hidePaging()
+{
+    ui->prevPage->hide();
+    ui->pageLabel->hide();
+    ui->nextPage->hide();
+}
+
+void MainWindow::onPrevPage()
+{
+    if (pageHistory.isEmpty() || !homskiyCache)
+        return;
+    QString first = pageHistory.takeLast();
+    pageStart = homskiyCache->counter().rank(first, ui->left->value(), ui->right->value());
+    showPage();
+}
 
+void MainWindow::onNextPage()
+{
+    if (!homskiyCache)
+        return;
+    QString last = pageLast;
+    ChainCounter& homskiyCounter = homskiyCache->counter();
+    if (!homskiyCounter.next(last, ui->left->value(), ui->right->value()))
+        return;
+    pageHistory.append(pageFirst);
+    pageStart = homskiyCounter.rank(last, ui->left->value(), ui->right->value());
+    showPage();
 }
 
 void MainWindow::onCheckEqual()
 {
+    if (ui->pageLabel->isVisible() && cfgCache && homskiyCache) {
+        // В постраничном режиме видна только страница: сравниваем языки
+        // потоково по окну длин, но не дальше kMaxComparedChains цепочек,
+        // чтобы окно не зависало на огромных языках. Грамматики берутся из
+        // кэшей, то есть с учётом фильтра, если он задан.
+        WordIterator cfgWords(cfgCache->grammar(), ui->left->value(), ui->right->value());
+        WordIterator homskiyWords(homskiyCache->grammar(), ui->left->value(), ui->right->value());
+        bool complete = false;
+        QList<WordDifference> differences = streamDiff(cfgWords, homskiyWords, 20, kMaxComparedChains, &complete);
+        if (differences.isEmpty()) {
+            QString text = complete ? QString("Все %1 цепочек совпадают.").arg(cfgWords.produced())
+                                    : QString("Первые %1 цепочек совпадают; сравнение ограничено этим числом, "
+                                              "дальше языки не проверялись.").arg(kMaxComparedChains);
+            QMessageBox::information(this, "Результат", text);
+            return;
+        }
+        QStringList lines;
+        for (const WordDifference& difference : differences)
+            lines.append(QString("%1: %2").arg(difference.inFirst ? "только КС" : "только Хомский")
+                             .arg(difference.word.isEmpty() ? QString("λ") : difference.word));
+        QMessageBox::information(this, "Результат", "Первые различия:\n" + lines.join("\n"));
+        return;
+    }
+
     QStandardItemModel* modelCFG = qobject_cast<QStandardItemModel*>(ui->listCFG->model());
     QStandardItemModel* modelHomskiy = qobject_cast<QStandardItemModel*>(ui->listHomskiy->model());
 
@@ -496,6 +678,80 @@ void MainWindow::onCheckEqual()
     }
 }
 
+void MainWindow::updateProfileStatus()
+{
+    if (Profiler::isEnabled())
+        ui->statusbar->showMessage(Profiler::summary());
+}
+
+void MainWindow::onExportTrace()
+{
+    QString filePath = QFileDialog::getSaveFileName(this, "Сохранить трассировку", "trace.json", "Chrome Trace (*.json)");
+    if (filePath.isEmpty())
+        return;
+    if (!Profiler::exportChromeTrace(filePath))
+        QMessageBox::warning(this, "Ошибка", "Не удалось сохранить трассировку.");
+}
+
+void MainWindow::onCheckAmbiguity()
+{
+    int maxLength = ui->right->value();
+    QByteArray entry = ResultCache::key(ResultCache::fingerprint(cfg), "ambiguity", {QString::number(maxLength)});
+    AmbiguityReport report;
+    if (!resultCache->get(entry, report)) {
+        // Перебор может занять долгое время, поэтому анализ идёт в пуле
+        // потоков, а окно показывает ход работы и позволяет его прервать.
+        Grammars::IndexedGrammar grammar = Grammars::IndexedGrammar::fromCFG(cfg);
+        std::atomic<int> done{0};
+        std::atomic<bool> cancel{false};
+        bool canceled = false;
+        QProgressDialog progress("Поиск неоднозначности…", "Прервать", 0, 1000, this);
+        progress.setWindowModality(Qt::WindowModal);
+        progress.setMinimumDuration(300);
+        QEventLoop loop;
+        QTimer timer;
+        connect(&timer, &QTimer::timeout, &progress, [&]() { progress.setValue(done); });
+        connect(&progress, &QProgressDialog::canceled, &loop, [&]() { cancel = true; });
+        QThreadPool::globalInstance()->start([&]() {
+            AmbiguityAnalyzer analyzer(grammar, maxLength);
+            analyzer.setProgress([&](int permille) {
+                done = permille;
+                return !cancel;
+            });
+            report = analyzer.analyze();
+            canceled = analyzer.wasCanceled();
+            QMetaObject::invokeMethod(&loop, &QEventLoop::quit, Qt::QueuedConnection);
+        });
+        timer.start(100);
+        loop.exec();
+        progress.reset();
+        // Прерванный отчёт неполон и в кэш не попадает.
+        if (!canceled)
+            resultCache->put(entry, report);
+    }
+
+    QString text;
+    if (report.ambiguous) {
+        text = QString("Грамматика неоднозначна.\nКратчайшая неоднозначная цепочка: %1\n1) %2\n2) %3\n")
+                   .arg(report.witness).arg(report.firstTree).arg(report.secondTree);
+        text += QString("\nНеоднозначные цепочки длины до %1: %2").arg(maxLength).arg(report.ambiguousWords.join(", "));
+        if (!report.complete)
+            text += ", …";
+        text += "\n";
+    } else if (report.complete) {
+        text = QString("Неоднозначных цепочек длины до %1 нет.\n").arg(maxLength);
+    } else {
+        text = QString("Неоднозначность до длины %1 не найдена, но перебор был ограничен или прерван.\n").arg(maxLength);
+    }
+
+    if (report.infinite)
+        text += "\nЧерез петлю A -> A цепочка имеет бесконечно много выводов; ниже петли не учтены.\n";
+    text += "\nЧисло выводов по длинам:";
+    for (int length = 1; length < report.derivationsPerLength.size(); ++length)
+        text += QString("\n%1: %2").arg(length).arg(report.derivationsPerLength[length]);
+    QMessageBox::information(this, "Однозначность", text);
+}
+
 void MainWindow::showContextMenuCFG(const QPoint &pos) {
     QModelIndex index = ui->listCFG->indexAt(pos);
     QMenu contextMenu(this);
@@ -504,6 +760,7 @@ void MainWindow::showContextMenuCFG(const QPoint &pos) {
     QAction *editAction = contextMenu.addAction("Редактировать");
     QAction *removeAction = contextMenu.addAction("Удалить");
     QAction *buildTree = contextMenu.addAction("Построить дерево вывода");
+    QAction *buildParseTree = contextMenu.addAction("Показать все выводы");
 
     connect(addAction, &QAction::triggered, this, &MainWindow::addRuleCFG);
     connect(editAction, &QAction::triggered, this, [this, index]() {
@@ -527,6 +784,13 @@ void MainWindow::showContextMenuCFG(const QPoint &pos) {
             QMessageBox::warning(this, "Ошибка", "Ничего не выбрано для построения дерева.");
         }
     });
+    connect(buildParseTree, &QAction::triggered, this, [this, index]() {
+        if (index.isValid()) {
+            buildParseTreeCFG(index);
+        } else {
+            QMessageBox::warning(this, "Ошибка", "Ничего не выбрано для построения дерева.");
+        }
+    });
 
     contextMenu.exec(ui->listCFG->viewport()->mapToGlobal(pos));
 }
@@ -539,6 +803,7 @@ void MainWindow::showContextMenuHomskiy(const QPoint &pos) {
     QAction *editAction = contextMenu.addAction("Редактировать");
     QAction *removeAction = contextMenu.addAction("Удалить");
     QAction *buildTree = contextMenu.addAction("Построить дерево вывода");
+    QAction *buildParseTree = contextMenu.addAction("Показать все выводы");
 
     connect(addAction, &QAction::triggered, this, &MainWindow::addRuleHomskiy);
     connect(editAction, &QAction::triggered, this, [this, index]() {
@@ -562,6 +827,13 @@ void MainWindow::showContextMenuHomskiy(const QPoint &pos) {
             QMessageBox::warning(this, "Ошибка", "Ничего не выбрано для построения дерева.");
         }
     });
+    connect(buildParseTree, &QAction::triggered, this, [this, index]() {
+        if (index.isValid()) {
+            buildParseTreeHomskiy(index);
+        } else {
+            QMessageBox::warning(this, "Ошибка", "Ничего не выбрано для построения дерева.");
+        }
+    });
 
     contextMenu.exec(ui->listHomskiy->viewport()->mapToGlobal(pos));
 }
@@ -591,15 +863,33 @@ void MainWindow::removeRuleCFG(const QModelIndex &index) {
     ui->listCFG->model()->removeRow(index.row());
 }
 
+QString derivationPath(const Grammars::IndexedGrammar& grammar, const QString& chain)
+{
+    CykParser parser(grammar);
+    if (!parser.parse(chain == "λ" ? QString() : chain))
+        return {};
+    if (parser.length() == 0)
+        return grammar.nonterminals[grammar.start] + " -> λ";
+    return parser.leftmostDerivation(parser.derivation(0, 0, parser.length(), grammar.start)).join(" -> ");
+}
+
 void MainWindow::buildRuleTreeCFG(const QModelIndex &index)
 {
     QString chain = ui->listCFG->model()->data(index).toString();
-    QString treePath = cfgTrees[chain];
+    QString treePath = derivationPath(Grammars::IndexedGrammar::fromCFG(cfg), chain);
 
     ChainTreeDialog *dialog = new ChainTreeDialog(chain, treePath, this);
     dialog->show();
 }
 
+void MainWindow::buildParseTreeCFG(const QModelIndex &index)
+{
+    QString chain = ui->listCFG->model()->data(index).toString();
+
+    ChainModal *dialog = new ChainModal(chain, cfg, this);
+    dialog->show();
+}
+
 void MainWindow::addRuleHomskiy() {
     bool ok;
     QString text = QInputDialog::getText(this, "Добавить правило", "Имя правила:", QLineEdit::Normal, "", &ok);
@@ -628,12 +918,20 @@ void MainWindow::removeRuleHomskiy(const QModelIndex &index) {
 void MainWindow::buildRuleTreeHomskiy(const QModelIndex &index)
 {
     QString chain = ui->listHomskiy->model()->data(index).toString();
-    QString treePath = homskiyTrees[chain];
+    QString treePath = derivationPath(Grammars::IndexedGrammar::fromHomskiy(homsky), chain);
 
     ChainTreeDialog *dialog = new ChainTreeDialog(chain, treePath, this);
     dialog->show();
 }
 
+void MainWindow::buildParseTreeHomskiy(const QModelIndex &index)
+{
+    QString chain = ui->listHomskiy->model()->data(index).toString();
+
+    ChainModal *dialog = new ChainModal(chain, homsky, this);
+    dialog->show();
+}
+
 MainWindow::~MainWindow()
 {
     delete ui;
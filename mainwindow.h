@@ -3,6 +3,8 @@
 
 #include <QMainWindow>
 #include <QListView>
+#include <memory>
+#include "profiler.h"
 
 namespace Grammars {
     struct CFG{
@@ -14,6 +16,7 @@ namespace Grammars {
         void generateChains(const QString& currentChain, int minLength, int maxLength,
                             QSet<QString>& result, QMap<QString, QString>& treeMap, const QString& path = "") {
             if (currentChain.length() > maxLength) return;
+            PROFILE_COUNT(SententialForms, 1);
 
             bool isTerminalChain = true;
             for (auto ch : currentChain) {
@@ -24,6 +27,7 @@ namespace Grammars {
             }
 
             if (isTerminalChain && currentChain.length() >= minLength) {
+                PROFILE_COUNT(WordsFound, 1);
                 result.insert(currentChain);
                 treeMap.insert(currentChain, path);
                 return;
@@ -33,6 +37,7 @@ namespace Grammars {
                 QChar symbol = currentChain[i];
                 if (rules.contains(symbol)) {
                     for (auto& rule : rules[symbol]) {
+                        PROFILE_COUNT(Expansions, 1);
                         QString newChain = currentChain;
                         newChain.removeAt(i);
                         for (int j = 0; j < rule.length(); ++j) {
@@ -49,6 +54,7 @@ namespace Grammars {
         }
 
         void generateAllChains(int minLength, int maxLength, QSet<QString>& result, QMap<QString, QString>& treeMap) {
+            PROFILE_SCOPE("CFG::generateAllChains");
             QString initialChain = QString{startSymbol};
             generateChains(initialChain, minLength, maxLength, result, treeMap);
         }
@@ -63,6 +69,7 @@ namespace Grammars {
         void generateChains(const QStringList& currentChain, int minLength, int maxLength,
                             QSet<QStringList>& result, QMap<QString, QString>& treeMap, const QString& path = "") {
             if (currentChain.length() > maxLength) return;
+            PROFILE_COUNT(SententialForms, 1);
 
             bool isTerminalChain = true;
             for (auto& ch : currentChain) {
@@ -73,6 +80,7 @@ namespace Grammars {
             }
 
             if (isTerminalChain && currentChain.length() >= minLength) {
+                PROFILE_COUNT(WordsFound, 1);
                 result.insert(currentChain);
                 treeMap.insert(currentChain.join(""), path);
                 return;
@@ -82,6 +90,7 @@ namespace Grammars {
                 QString symbol = currentChain[i];
                 if (rules.contains(symbol)) {
                     for (auto& rule : rules[symbol]) {
+                        PROFILE_COUNT(Expansions, 1);
                         QStringList newChain = currentChain;
                         newChain.removeAt(i);
                         for (int j = 0; j < rule.length(); ++j) {
@@ -98,12 +107,21 @@ namespace Grammars {
         }
 
         void generateAllChains(int minLength, int maxLength, QSet<QStringList>& result, QMap<QString, QString>& treeMap) {
+            PROFILE_SCOPE("Homskiy::generateAllChains");
             QStringList initialChain{startSymbol};
             generateChains(initialChain, minLength, maxLength, result, treeMap);
         }
     };
 }
 
+class ChainCache;
+class Dfa;
+class ResultCache;
+
+Grammars::CFG parseCFGFromJson(const QString& filePath);
+QString canonError(const Grammars::CFG& cfg);
+Grammars::Homskiy makeHomskyFromCFG(const Grammars::CFG& cfg);
+
 QT_BEGIN_NAMESPACE
 namespace Ui {
 class MainWindow;
@@ -122,27 +140,53 @@ private:
     Ui::MainWindow *ui;
     Grammars::CFG cfg;
     Grammars::Homskiy homsky;
-    QMap<QString, QString> cfgTrees;
-    QMap<QString, QString> homskiyTrees;
+    // Результаты между запусками: форма Хомского, анализ, цепочки по длинам.
+    std::shared_ptr<ResultCache> resultCache;
+    // Сбрасываются при смене грамматики, между показами переиспользуются.
+    std::shared_ptr<ChainCache> cfgCache;
+    std::shared_ptr<ChainCache> homskiyCache;
+    // Фильтр цепочек: при заданном выражении homskiyCache строится по
+    // пересечению с автоматом, а список КС-грамматики фильтруется им же.
+    QString chainFilter;
+    std::shared_ptr<Dfa> filterDfa;
+    // Номер вывода первой цепочки страницы. Для неоднозначной грамматики
+    // номера выводов не совпадают с позициями цепочек, поэтому назад
+    // переходим по rank() запомненных первых цепочек прежних страниц.
+    quint64 pageStart = 0;
+    QStringList pageHistory;
+    // Границы показанной страницы: списки редактируются, поэтому листаем
+    // по этим значениям, а не по содержимому представлений.
+    QString pageFirst;
+    QString pageLast;
 
     void updateUIRules(const Grammars::CFG& cfg);
     bool checkCanon(const Grammars::CFG& cfg);
     void translateToHomskiy();
+    void showPage();
+    void hidePaging();
+    bool updateFilter();
+    void updateProfileStatus();
 
 private slots:
     void onLoadConfiguration();
     void onCalculateHomskiy();
     void onShowChains();
     void onCheckEqual();
+    void onCheckAmbiguity();
+    void onExportTrace();
+    void onPrevPage();
+    void onNextPage();
     void showContextMenuCFG(const QPoint &pos);
     void showContextMenuHomskiy(const QPoint &pos);
     void addRuleCFG();
     void editRuleCFG(const QModelIndex &index);
     void removeRuleCFG(const QModelIndex &index);
     void buildRuleTreeCFG(const QModelIndex &index);
+    void buildParseTreeCFG(const QModelIndex &index);
     void addRuleHomskiy();
     void editRuleHomskiy(const QModelIndex &index);
     void removeRuleHomskiy(const QModelIndex &index);
     void buildRuleTreeHomskiy(const QModelIndex &index);
+    void buildParseTreeHomskiy(const QModelIndex &index);
 };
 #endif // MAINWINDOW_H
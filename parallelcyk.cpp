@@ -0,0 +1,147 @@
+#include "parallelcyk.h"
+#include "profiler.h"
+
+#include <QThread>
+#include <algorithm>
+#include <atomic>
+
+// Ячейки диагонали раздаются потокам непрерывными блоками соседних строк.
+static const int kBlockCells = 32;
+// Диагонали с меньшим объёмом работы (ячейки × слова строки) считаются в
+// вызывающем потоке: запуск задач обошёлся бы дороже.
+static const qint64 kMinParallelWork = 4096;
+
+ParallelCyk::ParallelCyk(const Grammars::IndexedGrammar &grammar)
+    : g(grammar)
+{
+    init();
+}
+
+ParallelCyk::ParallelCyk(const Grammars::Homskiy &homskiy)
+    : g(Grammars::IndexedGrammar::fromHomskiy(homskiy))
+{
+    init();
+}
+
+void ParallelCyk::init()
+{
+    setThreadCount(QThread::idealThreadCount());
+
+    int symbols = g.nonterminals.size();
+    rowSlot.assign(symbols, -1);
+    colSlot.assign(symbols, -1);
+    for (const auto& rule : g.binary) {
+        if (rowSlot[rule.left] < 0)
+            rowSlot[rule.left] = rowSymbols++;
+        if (colSlot[rule.right] < 0)
+            colSlot[rule.right] = colSymbols++;
+    }
+
+    ruleBegin.assign(symbols + 1, 0);
+    for (const auto& rule : g.binary)
+        ++ruleBegin[rule.lhs + 1];
+    for (int a = 0; a < symbols; ++a)
+        ruleBegin[a + 1] += ruleBegin[a];
+    rules.resize(g.binary.size());
+    std::vector<int> position(ruleBegin.begin(), ruleBegin.end() - 1);
+    for (const auto& rule : g.binary)
+        rules[position[rule.lhs]++] = {rowSlot[rule.left], colSlot[rule.right]};
+}
+
+void ParallelCyk::setThreadCount(int count)
+{
+    threads = std::max(count, 1);
+    pool.setMaxThreadCount(threads);
+}
+
+bool ParallelCyk::accepts(QStringView word)
+{
+    PROFILE_SCOPE("ParallelCyk::accepts");
+    std::vector<int> input;
+    input.reserve(word.size());
+    for (QChar symbol : word) {
+        int terminal = g.terminalIndex(symbol);
+        if (terminal < 0)
+            return false;
+        input.push_back(terminal);
+    }
+    if (input.empty())
+        return g.acceptsEmpty;
+    if (g.start < 0)
+        return false;
+
+    length = static_cast<int>(input.size());
+    stride = (length + 1 + 63) / 64;
+    rows.assign(static_cast<size_t>(length + 1) * rowSymbols * stride, 0);
+    cols.assign(static_cast<size_t>(length + 1) * colSymbols * stride, 0);
+
+    for (int i = 0; i < length; ++i) {
+        for (const auto& rule : g.unary) {
+            if (rule.terminal != input[i])
+                continue;
+            if (rowSlot[rule.lhs] >= 0)
+                row(i, rowSlot[rule.lhs])[(i + 1) / 64] |= quint64(1) << ((i + 1) % 64);
+            if (colSlot[rule.lhs] >= 0)
+                col(i + 1, colSlot[rule.lhs])[i / 64] |= quint64(1) << (i % 64);
+            if (length == 1 && rule.lhs == g.start)
+                return true;
+        }
+    }
+
+    for (int span = 2; span < length; ++span)
+        computeDiagonal(span);
+    return length > 1 && derives(g.start, 0, length);
+}
+
+bool ParallelCyk::derives(int nonterminal, int from, int to) const
+{
+    // Биты rows[from] стоят только правее from, биты cols[to] — только левее
+    // to, поэтому пересечение само ограничено точками разбиения from < k < to.
+    int first = (from + 1) / 64;
+    int last = (to - 1) / 64;
+    for (int r = ruleBegin[nonterminal]; r < ruleBegin[nonterminal + 1]; ++r) {
+        const quint64* left = row(from, rules[r].left);
+        const quint64* right = col(to, rules[r].right);
+        for (int w = first; w <= last; ++w)
+            if (left[w] & right[w])
+                return true;
+    }
+    return false;
+}
+
+void ParallelCyk::computeCell(int from, int to)
+{
+    for (int a = 0; a < g.nonterminals.size(); ++a) {
+        if ((rowSlot[a] < 0 && colSlot[a] < 0) || !derives(a, from, to))
+            continue;
+        if (rowSlot[a] >= 0)
+            row(from, rowSlot[a])[to / 64] |= quint64(1) << (to % 64);
+        if (colSlot[a] >= 0)
+            col(to, colSlot[a])[from / 64] |= quint64(1) << (from % 64);
+    }
+}
+
+void ParallelCyk::computeDiagonal(int span)
+{
+    int cells = length - span + 1;
+    qint64 work = qint64(cells) * (span / 64 + 1) * std::max<qsizetype>(g.binary.size(), 1);
+    if (threads == 1 || cells < 2 * kBlockCells || work < kMinParallelWork) {
+        for (int from = 0; from < cells; ++from)
+            computeCell(from, from + span);
+        return;
+    }
+
+    std::atomic<int> next{0};
+    auto worker = [this, span, cells, &next] {
+        for (int begin = next.fetch_add(kBlockCells); begin < cells; begin = next.fetch_add(kBlockCells)) {
+            int end = std::min(begin + kBlockCells, cells);
+            for (int from = begin; from < end; ++from)
+                computeCell(from, from + span);
+        }
+    };
+    int tasks = std::min(threads, (cells + kBlockCells - 1) / kBlockCells);
+    for (int i = 1; i < tasks; ++i)
+        pool.start(worker);
+    worker();
+    pool.waitForDone();
+}
@@ -0,0 +1,73 @@
+#ifndef PARALLELCYK_H
+#define PARALLELCYK_H
+
+#include "indexedgrammar.h"
+
+#include <QStringView>
+#include <QThreadPool>
+#include <vector>
+
+// Распознаватель CYK для длинных цепочек (тысячи символов), работающий
+// фронтом по антидиагоналям: все ячейки одной длины отрезка независимы и
+// считаются параллельно.
+//
+// Таблица хранится битовыми строками: rows[i][B] — множество концов k, для
+// которых B выводит w[i..k), cols[j][C] — множество начал k, для которых C
+// выводит w[k..j). Проверка правила A -> BC для ячейки (i, j) сводится к
+// пересечению двух непрерывных строк по 64 точки разбиения за операцию.
+// Ячейки одной диагонали имеют разные i и j и пишут в разные строки,
+// поэтому синхронизация нужна только между диагоналями.
+class ParallelCyk
+{
+public:
+    explicit ParallelCyk(const Grammars::IndexedGrammar& grammar);
+    explicit ParallelCyk(const Grammars::Homskiy& homskiy);
+
+    int threadCount() const { return threads; }
+    void setThreadCount(int count);
+
+    bool accepts(QStringView word);
+
+private:
+    struct Rule {
+        int left;       // номер строки в rows
+        int right;      // номер строки в cols
+    };
+
+    Grammars::IndexedGrammar g;
+    int threads;
+    QThreadPool pool;
+
+    // Правила сгруппированы по левой части: ruleBegin[A]..ruleBegin[A + 1].
+    std::vector<int> ruleBegin;
+    std::vector<Rule> rules;
+    std::vector<int> rowSlot;       // нетерминал -> строка rows, -1 если не нужен
+    std::vector<int> colSlot;
+    int rowSymbols = 0;
+    int colSymbols = 0;
+
+    int length = 0;
+    int stride = 0;
+    std::vector<quint64> rows;
+    std::vector<quint64> cols;
+
+    void init();
+    bool derives(int nonterminal, int from, int to) const;
+    void computeCell(int from, int to);
+    void computeDiagonal(int span);
+
+    quint64* row(int position, int slot) {
+        return rows.data() + (static_cast<size_t>(position) * rowSymbols + slot) * stride;
+    }
+    quint64* col(int position, int slot) {
+        return cols.data() + (static_cast<size_t>(position) * colSymbols + slot) * stride;
+    }
+    const quint64* row(int position, int slot) const {
+        return rows.data() + (static_cast<size_t>(position) * rowSymbols + slot) * stride;
+    }
+    const quint64* col(int position, int slot) const {
+        return cols.data() + (static_cast<size_t>(position) * colSymbols + slot) * stride;
+    }
+};
+
+#endif // PARALLELCYK_H
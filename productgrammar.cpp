@@ -0,0 +1,201 @@
+#include "productgrammar.h"
+#include "indexedgrammar.h"
+
+#include <QSet>
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+namespace {
+    class Product
+    {
+    public:
+        Product(const Grammars::IndexedGrammar& grammar, const Dfa& dfa)
+            : g(grammar)
+            , dfa(dfa)
+            , states(dfa.stateCount())
+            , live(dfa.liveStates())
+            , productive(size_t(g.nonterminals.size()) * states * states, false)
+            , ends(size_t(g.nonterminals.size()) * states)
+            , starts(size_t(g.nonterminals.size()) * states)
+            , byLeft(g.nonterminals.size())
+            , byRight(g.nonterminals.size())
+        {
+            for (int terminal = 0; terminal < g.terminals.size(); ++terminal)
+                symbolIds.append(dfa.alphabet().indexOf(g.terminals[terminal][0]));
+            for (int index = 0; index < g.binary.size(); ++index) {
+                byLeft[g.binary[index].left].push_back(index);
+                byRight[g.binary[index].right].push_back(index);
+            }
+        }
+
+        int triples = 0;
+
+        bool isProductive(int a, int p, int q) const { return productive[key(a, p, q)]; }
+        int target(int terminal, int p) const {
+            int symbol = symbolIds[terminal];
+            return symbol < 0 ? -1 : dfa.nextByIndex(p, symbol);
+        }
+        // Конечные состояния q продуктивных троек (A, p, q).
+        const std::vector<int>& endsFrom(int a, int p) const { return ends[size_t(a) * states + p]; }
+
+        void build() {
+            for (const Grammars::IndexedGrammar::Unary& rule : g.unary)
+                for (int p = 0; p < states; ++p) {
+                    int q = target(rule.terminal, p);
+                    if (q >= 0)
+                        add(rule.lhs, p, q);
+                }
+
+            // Каждая тройка при извлечении сочетается с уже извлечёнными
+            // партнёрами слева и справа, поэтому каждая пара рассматривается
+            // ровно один раз — когда извлечена вторая из них.
+            std::vector<int> processedEnds(ends.size(), 0);
+            std::vector<int> processedStarts(starts.size(), 0);
+            for (size_t head = 0; head < worklist.size(); ++head) {
+                auto [b, p, r] = worklist[head];
+                for (int index : byLeft[b]) {
+                    const Grammars::IndexedGrammar::Binary& rule = g.binary[index];
+                    size_t slot = size_t(rule.right) * states + r;
+                    for (int i = 0; i < processedEnds[slot]; ++i)
+                        add(rule.lhs, p, ends[slot][i]);
+                }
+                for (int index : byRight[b]) {
+                    const Grammars::IndexedGrammar::Binary& rule = g.binary[index];
+                    size_t slot = size_t(rule.left) * states + p;
+                    for (int i = 0; i < processedStarts[slot]; ++i)
+                        add(rule.lhs, starts[slot][i], r);
+                }
+                // Правила вида A -> BB: пара тройки с самой собой.
+                ++processedEnds[size_t(b) * states + p];
+                ++processedStarts[size_t(b) * states + r];
+                for (int index : byLeft[b]) {
+                    const Grammars::IndexedGrammar::Binary& rule = g.binary[index];
+                    if (rule.right == b && p == r)
+                        add(rule.lhs, p, r);
+                }
+            }
+        }
+
+    private:
+        struct Triple {
+            int a;
+            int p;
+            int q;
+        };
+
+        const Grammars::IndexedGrammar& g;
+        const Dfa& dfa;
+        int states;
+        QList<bool> live;
+        QList<int> symbolIds;
+        std::vector<bool> productive;
+        std::vector<std::vector<int>> ends;     // (A, p) -> q
+        std::vector<std::vector<int>> starts;   // (A, q) -> p
+        std::vector<std::vector<int>> byLeft;
+        std::vector<std::vector<int>> byRight;
+        std::vector<Triple> worklist;
+
+        size_t key(int a, int p, int q) const { return (size_t(a) * states + p) * states + q; }
+
+        void add(int a, int p, int q) {
+            // Из тупикового состояния допускающее недостижимо: такая тройка
+            // не войдёт ни в один вывод результата.
+            if (!live[q] || productive[key(a, p, q)])
+                return;
+            productive[key(a, p, q)] = true;
+            ends[size_t(a) * states + p].push_back(q);
+            starts[size_t(a) * states + q].push_back(p);
+            worklist.push_back({a, p, q});
+            ++triples;
+        }
+    };
+}
+
+Grammars::Homskiy intersectWithDfa(const Grammars::Homskiy &homskiy, const Dfa &dfa, ProductStats *stats)
+{
+    return intersectWithDfa(Grammars::IndexedGrammar::fromHomskiy(homskiy), dfa, stats);
+}
+
+Grammars::Homskiy intersectWithDfa(const Grammars::IndexedGrammar &g, const Dfa &dfa, ProductStats *stats)
+{
+    PROFILE_SCOPE("intersectWithDfa");
+    Product product(g, dfa);
+    product.build();
+
+    auto name = [&](int a, int p, int q) {
+        return QString("%1[%2,%3]").arg(g.nonterminals[a]).arg(p).arg(q);
+    };
+
+    Grammars::Homskiy result;
+    result.terminals = QSet<QString>(g.terminals.begin(), g.terminals.end());
+    result.startSymbol = QString("%1[%2]").arg(g.nonterminals[g.start]).arg(dfa.start());
+    result.nonterminals.insert(result.startSymbol);
+
+    // Обход от старта: правила строятся только для достижимых троек.
+    QList<QStringList> startRules;
+    QSet<QString> visited;
+    QList<std::tuple<int, int, int>> queue;
+    auto visit = [&](int a, int p, int q) {
+        QString symbol = name(a, p, q);
+        if (!visited.contains(symbol)) {
+            visited.insert(symbol);
+            queue.append({a, p, q});
+        }
+        return symbol;
+    };
+
+    for (int f = 0; f < dfa.stateCount(); ++f)
+        if (dfa.isAccepting(f) && product.isProductive(g.start, dfa.start(), f))
+            visit(g.start, dfa.start(), f);
+    QSet<QString> finals = visited;
+
+    for (int head = 0; head < queue.size(); ++head) {
+        auto [a, p, q] = queue[head];
+        QList<QStringList> rules;
+        for (int index : g.unaryByLhs[a])
+            if (product.target(g.unary[index].terminal, p) == q)
+                rules.append(QStringList{g.terminals[g.unary[index].terminal]});
+        for (int index : g.binaryByLhs[a]) {
+            const Grammars::IndexedGrammar::Binary& rule = g.binary[index];
+            for (int r : product.endsFrom(rule.left, p))
+                if (product.isProductive(rule.right, r, q))
+                    rules.append(QStringList{visit(rule.left, p, r), visit(rule.right, r, q)});
+        }
+        QString symbol = name(a, p, q);
+        result.nonterminals.insert(symbol);
+        result.rules.insert(symbol, rules);
+        if (finals.contains(symbol))
+            startRules.append(rules);
+    }
+
+    // Новый стартовый символ объединяет выводы S[q0,f] по допускающим f и не
+    // встречается в правых частях, как того требует нормальная форма.
+    if (g.acceptsEmpty && dfa.isAccepting(dfa.start()))
+        startRules.append(QStringList{"λ"});
+    result.rules.insert(result.startSymbol, startRules);
+
+    // Тройки S[q0,f], на которые нет ссылок, заменены новым стартом.
+    for (const QString& symbol : finals) {
+        bool referenced = false;
+        for (const QList<QStringList>& rules : result.rules)
+            for (const QStringList& rule : rules)
+                referenced |= rule.contains(symbol);
+        if (!referenced) {
+            result.rules.remove(symbol);
+            result.nonterminals.remove(symbol);
+        }
+    }
+
+    if (stats) {
+        QList<bool> live = dfa.liveStates();
+        stats->dfaStates = dfa.stateCount();
+        stats->liveStates = int(std::count(live.begin(), live.end(), true));
+        stats->triples = product.triples;
+        stats->nonterminals = result.nonterminals.size();
+        stats->rules = 0;
+        for (const QList<QStringList>& rules : result.rules)
+            stats->rules += rules.size();
+    }
+    return result;
+}
@@ -0,0 +1,29 @@
+#ifndef PRODUCTGRAMMAR_H
+#define PRODUCTGRAMMAR_H
+
+#include "dfa.h"
+#include "indexedgrammar.h"
+#include "mainwindow.h"
+
+struct ProductStats {
+    int dfaStates = 0;
+    int liveStates = 0;
+    int triples = 0;        // продуктивных троек (A, p, q)
+    int nonterminals = 0;   // после отсечения недостижимых
+    int rules = 0;
+};
+
+// Пересечение языка грамматики в нормальной форме Хомского с регулярным
+// языком автомата (конструкция Бар-Хиллела). Нетерминалы результата —
+// тройки A[p,q]: A выводит цепочку, переводящую автомат из p в q. Тройки
+// строятся снизу вверх только для продуктивных комбинаций и только с
+// живыми конечными состояниями, затем отсекаются недостижимые из старта,
+// так что вместо |N|·|Q|² нетерминалов остаются лишь нужные.
+Grammars::Homskiy intersectWithDfa(const Grammars::Homskiy& homskiy, const Dfa& dfa,
+                                   ProductStats* stats = nullptr);
+// То же для бинарной формы; так фильтруется и КС-грамматика через fromCFG,
+// не проходя через форму Хомского.
+Grammars::Homskiy intersectWithDfa(const Grammars::IndexedGrammar& grammar, const Dfa& dfa,
+                                   ProductStats* stats = nullptr);
+
+#endif // PRODUCTGRAMMAR_H
@@ -0,0 +1,221 @@
+#include "profiler.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QStringList>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <vector>
+
+namespace {
+    struct TraceEvent {
+        const char* name;
+        qint64 start;
+        qint64 duration;
+        int thread;
+        quint64 allocations;
+    };
+
+    const char* const kCounterNames[Profiler::CounterCount] = {
+        "expansions",
+        "sentential forms",
+        "words found",
+        "rules created",
+        "allocations"
+    };
+
+    std::atomic<quint64> counters[Profiler::CounterCount];
+    std::atomic<int> nextThreadId{1};
+    thread_local int threadId = 0;
+
+    QMutex& eventsMutex() {
+        static QMutex mutex;
+        return mutex;
+    }
+
+    std::vector<TraceEvent>& events() {
+        static std::vector<TraceEvent> list;
+        return list;
+    }
+
+    qint64 nowUs() {
+        static QElapsedTimer timer = [] { QElapsedTimer t; t.start(); return t; }();
+        return timer.nsecsElapsed() / 1000;
+    }
+
+    int currentThread() {
+        if (threadId == 0)
+            threadId = nextThreadId.fetch_add(1, std::memory_order_relaxed);
+        return threadId;
+    }
+}
+
+#if defined(TPL_PROFILING) && defined(__GLIBC__)
+// Qt выделяет память контейнеров через malloc, а не через operator new,
+// поэтому считаются вызовы самого malloc. Выровненные выделения (operator new
+// для сверхвыровненных типов, часть Qt) идут мимо malloc и перехватываются
+// отдельно.
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* pointer, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void* __libc_valloc(size_t size);
+void* __libc_pvalloc(size_t size);
+
+void* malloc(size_t size) {
+    counters[Profiler::Allocations].fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    counters[Profiler::Allocations].fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, size_t size) {
+    counters[Profiler::Allocations].fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(pointer, size);
+}
+
+void* memalign(size_t alignment, size_t size) {
+    counters[Profiler::Allocations].fetch_add(1, std::memory_order_relaxed);
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    counters[Profiler::Allocations].fetch_add(1, std::memory_order_relaxed);
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** pointer, size_t alignment, size_t size) {
+    if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0)
+        return EINVAL;
+    counters[Profiler::Allocations].fetch_add(1, std::memory_order_relaxed);
+    void* result = __libc_memalign(alignment, size);
+    if (!result)
+        return ENOMEM;
+    *pointer = result;
+    return 0;
+}
+
+void* valloc(size_t size) {
+    counters[Profiler::Allocations].fetch_add(1, std::memory_order_relaxed);
+    return __libc_valloc(size);
+}
+
+void* pvalloc(size_t size) {
+    counters[Profiler::Allocations].fetch_add(1, std::memory_order_relaxed);
+    return __libc_pvalloc(size);
+}
+}
+#endif
+
+namespace Profiler {
+
+bool isEnabled()
+{
+#ifdef TPL_PROFILING
+    return true;
+#else
+    return false;
+#endif
+}
+
+void add(Counter counter, quint64 value)
+{
+    counters[counter].fetch_add(value, std::memory_order_relaxed);
+}
+
+quint64 value(Counter counter)
+{
+    return counters[counter].load(std::memory_order_relaxed);
+}
+
+void reset()
+{
+    for (auto& counter : counters)
+        counter.store(0, std::memory_order_relaxed);
+    QMutexLocker locker(&eventsMutex());
+    events().clear();
+}
+
+QString summary()
+{
+    if (!isEnabled())
+        return "Профилирование отключено";
+
+    QStringList parts;
+    {
+        QMutexLocker locker(&eventsMutex());
+        // Последний замер каждой стадии.
+        QStringList seen;
+        for (auto it = events().rbegin(); it != events().rend(); ++it) {
+            QString name = QString::fromLatin1(it->name);
+            if (seen.contains(name))
+                continue;
+            seen.append(name);
+            parts.prepend(QString("%1: %2 мс").arg(name).arg(it->duration / 1000.0, 0, 'f', 1));
+        }
+    }
+    for (int i = 0; i < CounterCount; ++i)
+        parts.append(QString("%1: %2").arg(QString::fromLatin1(kCounterNames[i])).arg(value(Counter(i))));
+    return parts.join(" | ");
+}
+
+bool exportChromeTrace(const QString& path)
+{
+    QJsonArray traceEvents;
+    qint64 end = 0;
+    {
+        QMutexLocker locker(&eventsMutex());
+        for (const TraceEvent& event : events()) {
+            QJsonObject object;
+            object["name"] = QString::fromLatin1(event.name);
+            object["ph"] = "X";
+            object["ts"] = event.start;
+            object["dur"] = event.duration;
+            object["pid"] = 1;
+            object["tid"] = event.thread;
+            object["args"] = QJsonObject{{"allocations", double(event.allocations)}};
+            traceEvents.append(object);
+            end = std::max(end, event.start + event.duration);
+        }
+    }
+
+    QJsonObject args;
+    for (int i = 0; i < CounterCount; ++i)
+        args[QString::fromLatin1(kCounterNames[i])] = double(value(Counter(i)));
+    traceEvents.append(QJsonObject{{"name", "counters"}, {"ph", "C"}, {"ts", end}, {"pid", 1}, {"tid", 0}, {"args", args}});
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Could not open the file!";
+        return false;
+    }
+    file.write(QJsonDocument(QJsonObject{{"traceEvents", traceEvents}, {"displayTimeUnit", "ms"}}).toJson(QJsonDocument::Compact));
+    return true;
+}
+
+ScopedTimer::ScopedTimer(const char* name)
+    : name(name)
+    , start(nowUs())
+    , allocations(value(Allocations))
+{
+}
+
+ScopedTimer::~ScopedTimer()
+{
+    TraceEvent event{name, start, nowUs() - start, currentThread(), value(Allocations) - allocations};
+    QMutexLocker locker(&eventsMutex());
+    events().push_back(event);
+}
+
+}
@@ -0,0 +1,50 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <QString>
+#include <QtGlobal>
+
+// Встроенное профилирование: таймеры областей и счётчики событий.
+// Включается сборкой с CONFIG+=profiling (define TPL_PROFILING); без него
+// макросы PROFILE_SCOPE и PROFILE_COUNT не порождают никакого кода.
+namespace Profiler {
+    enum Counter {
+        Expansions,
+        SententialForms,
+        WordsFound,
+        RulesCreated,
+        Allocations,
+        CounterCount
+    };
+
+    bool isEnabled();
+    void add(Counter counter, quint64 value = 1);
+    quint64 value(Counter counter);
+    void reset();
+    QString summary();
+    bool exportChromeTrace(const QString& path);
+
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer(const char* name);
+        ~ScopedTimer();
+
+    private:
+        const char* name;
+        qint64 start;
+        quint64 allocations;
+    };
+}
+
+#ifdef TPL_PROFILING
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+#define PROFILE_SCOPE(name) Profiler::ScopedTimer PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_COUNT(counter, value) Profiler::add(Profiler::counter, value)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_COUNT(counter, value) ((void)0)
+#endif
+
+#endif // PROFILER_H
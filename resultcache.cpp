@@ -0,0 +1,143 @@
+#include "resultcache.h"
+#include "profiler.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <algorithm>
+
+static const quint32 kMagic = 0x54504c43;  // "TPLC"
+
+QDataStream &operator<<(QDataStream &stream, const Grammars::Homskiy &homskiy)
+{
+    return stream << homskiy.terminals << homskiy.nonterminals << homskiy.rules << homskiy.startSymbol;
+}
+
+QDataStream &operator>>(QDataStream &stream, Grammars::Homskiy &homskiy)
+{
+    return stream >> homskiy.terminals >> homskiy.nonterminals >> homskiy.rules >> homskiy.startSymbol;
+}
+
+QDataStream &operator<<(QDataStream &stream, const AmbiguityReport &report)
+{
+    return stream << report.derivationsPerLength << report.ambiguous << report.complete << report.infinite << report.witness
+                  << report.firstTree << report.secondTree << report.ambiguousWords;
+}
+
+QDataStream &operator>>(QDataStream &stream, AmbiguityReport &report)
+{
+    return stream >> report.derivationsPerLength >> report.ambiguous >> report.complete >> report.infinite >> report.witness
+                  >> report.firstTree >> report.secondTree >> report.ambiguousWords;
+}
+
+ResultCache::ResultCache(const QString &directory)
+    : root(directory.isEmpty() ? QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/results"
+                               : directory)
+{
+}
+
+QByteArray ResultCache::fingerprint(const Grammars::CFG &cfg)
+{
+    QList<QChar> terminals(cfg.terminals.begin(), cfg.terminals.end());
+    QList<QChar> nonterminals(cfg.nonterminals.begin(), cfg.nonterminals.end());
+    std::sort(terminals.begin(), terminals.end());
+    std::sort(nonterminals.begin(), nonterminals.end());
+
+    // Порядок альтернатив сохраняется: от него зависят имена новых
+    // нетерминалов формы Хомского.
+    QByteArray buffer;
+    QDataStream stream(&buffer, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << QString("cfg") << terminals << nonterminals << cfg.startSymbol << cfg.rules;
+    return QCryptographicHash::hash(buffer, QCryptographicHash::Sha256);
+}
+
+QByteArray ResultCache::fingerprint(const Grammars::IndexedGrammar &grammar)
+{
+    // Символы IndexedGrammar уже упорядочены при построении.
+    QByteArray buffer;
+    QDataStream stream(&buffer, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << QString("indexed") << grammar.terminals << grammar.nonterminals << grammar.start << grammar.acceptsEmpty;
+    for (const Grammars::IndexedGrammar::Binary& rule : grammar.binary)
+        stream << rule.lhs << rule.left << rule.right;
+    for (const Grammars::IndexedGrammar::Unary& rule : grammar.unary)
+        stream << rule.lhs << rule.terminal;
+    return QCryptographicHash::hash(buffer, QCryptographicHash::Sha256);
+}
+
+QByteArray ResultCache::key(const QByteArray &fingerprint, const QString &operation, const QStringList &parameters)
+{
+    QByteArray buffer;
+    QDataStream stream(&buffer, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << kFormatVersion << fingerprint << operation << parameters;
+    return QCryptographicHash::hash(buffer, QCryptographicHash::Sha256);
+}
+
+QString ResultCache::path(const QByteArray &key) const
+{
+    return root + "/" + QString::fromLatin1(key.toHex()) + ".bin";
+}
+
+bool ResultCache::load(const QByteArray &key, QByteArray &payload) const
+{
+    if (!enabled)
+        return false;
+    PROFILE_SCOPE("ResultCache::load");
+    QFile file(path(key));
+    if (!file.open(QIODevice::ReadOnly)) {
+        ++missCount;
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    quint32 magic = 0;
+    quint16 version = 0;
+    QByteArray storedKey;
+    QByteArray compressed;
+    stream >> magic >> version >> storedKey >> compressed;
+    if (stream.status() != QDataStream::Ok || magic != kMagic || version != kFormatVersion || storedKey != key) {
+        ++missCount;
+        return false;
+    }
+    payload = qUncompress(compressed);
+    if (payload.isEmpty()) {
+        ++missCount;
+        return false;
+    }
+    ++hitCount;
+    return true;
+}
+
+bool ResultCache::store(const QByteArray &key, const QByteArray &payload) const
+{
+    if (!enabled || !QDir().mkpath(root))
+        return false;
+    PROFILE_SCOPE("ResultCache::store");
+    QSaveFile file(path(key));
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << kMagic << kFormatVersion << key << qCompress(payload);
+    if (stream.status() != QDataStream::Ok) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+Grammars::Homskiy ResultCache::homskiyFromCFG(const Grammars::CFG &cfg) const
+{
+    QByteArray entry = key(fingerprint(cfg), "homskiy");
+    Grammars::Homskiy homskiy;
+    if (get(entry, homskiy))
+        return homskiy;
+    homskiy = makeHomskyFromCFG(cfg);
+    put(entry, homskiy);
+    return homskiy;
+}
@@ -0,0 +1,86 @@
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+#include "ambiguity.h"
+#include "indexedgrammar.h"
+#include "mainwindow.h"
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QString>
+#include <QStringList>
+
+QDataStream& operator<<(QDataStream& stream, const Grammars::Homskiy& homskiy);
+QDataStream& operator>>(QDataStream& stream, Grammars::Homskiy& homskiy);
+QDataStream& operator<<(QDataStream& stream, const AmbiguityReport& report);
+QDataStream& operator>>(QDataStream& stream, AmbiguityReport& report);
+
+// Постоянный кэш результатов между запусками, адресуемый содержимым.
+//
+// Ключ — SHA-256 от версии формата, канонического отпечатка грамматики
+// (множества упорядочены, поэтому порядок обхода QSet не влияет), имени
+// операции и её параметров. Каждая запись — отдельный файл <ключ>.bin:
+// сигнатура, версия формата, ключ и сжатые qCompress данные QDataStream.
+// Запись с другой версией или повреждённая считается промахом; файлы
+// пишутся через QSaveFile, поэтому прерванная запись не портит кэш.
+class ResultCache
+{
+public:
+    static const quint16 kFormatVersion = 2;
+
+    // Пустой каталог — QStandardPaths::CacheLocation.
+    explicit ResultCache(const QString& directory = QString());
+
+    const QString& directory() const { return root; }
+    bool isEnabled() const { return enabled; }
+    void setEnabled(bool value) { enabled = value; }
+
+    static QByteArray fingerprint(const Grammars::CFG& cfg);
+    static QByteArray fingerprint(const Grammars::IndexedGrammar& grammar);
+    static QByteArray key(const QByteArray& fingerprint, const QString& operation,
+                          const QStringList& parameters = QStringList());
+
+    bool load(const QByteArray& key, QByteArray& payload) const;
+    bool store(const QByteArray& key, const QByteArray& payload) const;
+
+    template<typename T>
+    bool get(const QByteArray& key, T& value) const {
+        QByteArray payload;
+        if (!load(key, payload))
+            return false;
+        QDataStream stream(payload);
+        stream.setVersion(QDataStream::Qt_6_0);
+        T result;
+        stream >> result;
+        if (stream.status() != QDataStream::Ok)
+            return false;
+        value = result;
+        return true;
+    }
+
+    template<typename T>
+    bool put(const QByteArray& key, const T& value) const {
+        QByteArray payload;
+        QDataStream stream(&payload, QIODevice::WriteOnly);
+        stream.setVersion(QDataStream::Qt_6_0);
+        stream << value;
+        return store(key, payload);
+    }
+
+    // makeHomskyFromCFG с кэшированием: при попадании преобразование не
+    // выполняется вовсе.
+    Grammars::Homskiy homskiyFromCFG(const Grammars::CFG& cfg) const;
+
+    quint64 hits() const { return hitCount; }
+    quint64 misses() const { return missCount; }
+
+private:
+    QString root;
+    bool enabled = true;
+    mutable quint64 hitCount = 0;
+    mutable quint64 missCount = 0;
+
+    QString path(const QByteArray& key) const;
+};
+
+#endif // RESULTCACHE_H
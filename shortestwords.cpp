@@ -0,0 +1,78 @@
+#include "shortestwords.h"
+#include "worditerator.h"
+#include "profiler.h"
+
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+ShortestWords::ShortestWords(const Grammars::IndexedGrammar &grammar)
+    : g(grammar)
+    , lengths(grammar.nonterminals.size(), -1)
+    , bestRule(grammar.nonterminals.size(), -1)
+{
+    PROFILE_SCOPE("ShortestWords");
+    const int symbols = g.nonterminals.size();
+    std::vector<std::vector<int>> rulesByChild(symbols);
+    std::vector<int> pending(g.binary.size(), 2);
+    for (int i = 0; i < g.binary.size(); ++i) {
+        rulesByChild[g.binary[i].left].push_back(i);
+        rulesByChild[g.binary[i].right].push_back(i);
+    }
+
+    using Candidate = std::pair<int, int>;   // длина, нетерминал
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> queue;
+    QList<int> best(symbols, -1);
+    auto offer = [&](int nonterminal, int length, int rule) {
+        if (lengths[nonterminal] >= 0 || (best[nonterminal] >= 0 && best[nonterminal] <= length))
+            return;
+        best[nonterminal] = length;
+        bestRule[nonterminal] = rule;
+        queue.push({length, nonterminal});
+    };
+    for (int i = 0; i < g.unary.size(); ++i)
+        offer(g.unary[i].lhs, 1, -2 - i);
+
+    while (!queue.empty()) {
+        auto [length, nonterminal] = queue.top();
+        queue.pop();
+        if (lengths[nonterminal] >= 0)
+            continue;
+        lengths[nonterminal] = length;
+        for (int index : rulesByChild[nonterminal]) {
+            // Правило A -> BB записано в rulesByChild[B] дважды и ждёт оба раза.
+            const auto& rule = g.binary[index];
+            if (--pending[index] == 0)
+                offer(rule.lhs, lengths[rule.left] + lengths[rule.right], index);
+        }
+    }
+}
+
+void ShortestWords::appendWord(int nonterminal, QList<int> &out) const
+{
+    int rule = bestRule[nonterminal];
+    if (lengths[nonterminal] < 0)
+        return;
+    if (rule <= -2) {
+        out.append(g.unary[-2 - rule].terminal);
+        return;
+    }
+    appendWord(g.binary[rule].left, out);
+    appendWord(g.binary[rule].right, out);
+}
+
+QString ShortestWords::word(int nonterminal) const
+{
+    QList<int> terminals;
+    appendWord(nonterminal, terminals);
+    return g.fromTerminals(terminals);
+}
+
+QStringList ShortestWords::shortestWords(int k) const
+{
+    if (g.start < 0)
+        return {};
+    int from = g.acceptsEmpty || lengths[g.start] < 0 ? 0 : lengths[g.start];
+    return WordIterator(g, from).take(k);
+}
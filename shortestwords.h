@@ -0,0 +1,37 @@
+#ifndef SHORTESTWORDS_H
+#define SHORTESTWORDS_H
+
+#include "indexedgrammar.h"
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+// Кратчайшие цепочки, выводимые каждым нетерминалом (алгоритм Кнута —
+// обобщение Дейкстры на грамматики). Нетерминалы извлекаются из очереди по
+// возрастанию длины; правило становится применимым, когда окончательно
+// известны оба его нетерминала справа. Время O(R log N) по числу правил.
+class ShortestWords
+{
+public:
+    explicit ShortestWords(const Grammars::IndexedGrammar& grammar);
+
+    const Grammars::IndexedGrammar& grammar() const { return g; }
+
+    // -1, если нетерминал не порождает терминальных цепочек.
+    int length(int nonterminal) const { return lengths[nonterminal]; }
+    QString word(int nonterminal) const;
+    void appendWord(int nonterminal, QList<int>& out) const;
+
+    // k кратчайших различных цепочек языка (при равной длине — в
+    // лексикографическом порядке); перебор начинается сразу с длины
+    // кратчайшей цепочки.
+    QStringList shortestWords(int k) const;
+
+private:
+    Grammars::IndexedGrammar g;
+    QList<int> lengths;
+    QList<int> bestRule;    // индекс в binary, либо -2 - индекс в unary
+};
+
+#endif // SHORTESTWORDS_H
@@ -0,0 +1,160 @@
+#include "worditerator.h"
+#include "profiler.h"
+
+#include <algorithm>
+#include <functional>
+
+WordIterator::WordIterator(const Grammars::IndexedGrammar &grammar, int minLength, int maxLength)
+    : counter(grammar, 0)
+    , maxLength(maxLength)
+    , currentLength(std::max(minLength, 0))
+{
+    computeLongest();
+}
+
+WordIterator::WordIterator(const Grammars::CFG &cfg, int minLength, int maxLength)
+    : WordIterator(Grammars::IndexedGrammar::fromCFG(cfg), minLength, maxLength)
+{
+}
+
+WordIterator::WordIterator(const Grammars::Homskiy &homskiy, int minLength, int maxLength)
+    : WordIterator(Grammars::IndexedGrammar::fromHomskiy(homskiy), minLength, maxLength)
+{
+}
+
+void WordIterator::computeLongest()
+{
+    const auto& g = counter.grammar();
+    const int symbols = g.nonterminals.size();
+    if (g.start < 0) {
+        longest = 0;
+        return;
+    }
+
+    QList<bool> productive(symbols, false);
+    for (const auto& rule : g.unary)
+        productive[rule.lhs] = true;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (const auto& rule : g.binary) {
+            if (!productive[rule.lhs] && productive[rule.left] && productive[rule.right]) {
+                productive[rule.lhs] = true;
+                changed = true;
+            }
+        }
+    }
+
+    // Самая длинная цепочка из A по полезным правилам; цикл через
+    // достижимый нетерминал означает бесконечный язык.
+    enum { Unvisited, InProgress, Done };
+    QList<int> state(symbols, Unvisited);
+    QList<int> length(symbols, 0);
+    bool infinite = false;
+    std::function<void(int)> visit = [&](int a) {
+        state[a] = InProgress;
+        if (!g.unaryByLhs[a].isEmpty())
+            length[a] = 1;
+        for (int index : g.binaryByLhs[a]) {
+            const auto& rule = g.binary[index];
+            if (!productive[rule.left] || !productive[rule.right])
+                continue;
+            for (int child : {rule.left, rule.right}) {
+                if (state[child] == InProgress)
+                    infinite = true;
+                else if (state[child] == Unvisited)
+                    visit(child);
+            }
+            if (infinite)
+                return;
+            length[a] = std::max(length[a], length[rule.left] + length[rule.right]);
+        }
+        state[a] = Done;
+    };
+    if (productive[g.start])
+        visit(g.start);
+    longest = infinite ? -1 : length[g.start];
+}
+
+int WordIterator::lengthLimit() const
+{
+    if (longest < 0)
+        return maxLength;
+    return maxLength < 0 ? longest : std::min(maxLength, longest);
+}
+
+bool WordIterator::next(QString &word)
+{
+    const int limit = lengthLimit();
+    if (started && currentLength > 0 && counter.next(current, currentLength, currentLength)) {
+        word = current;
+        ++count;
+        return true;
+    }
+    if (started)
+        ++currentLength;
+    started = true;
+
+    for (; limit < 0 || currentLength <= limit; ++currentLength) {
+        if (currentLength == 0) {
+            if (counter.grammar().acceptsEmpty) {
+                current.clear();
+                word = current;
+                ++count;
+                return true;
+            }
+            continue;
+        }
+        PROFILE_SCOPE("WordIterator::nextLength");
+        counter.extend(currentLength);
+        if (counter.nonterminalCount(counter.grammar().start, currentLength) == 0)
+            continue;
+        if (counter.unrank(0, currentLength, currentLength, current)) {
+            word = current;
+            ++count;
+            return true;
+        }
+    }
+    return false;
+}
+
+QStringList WordIterator::take(int count)
+{
+    QStringList result;
+    QString word;
+    while (result.size() < count && next(word))
+        result.append(word);
+    return result;
+}
+
+static bool shortlexLess(const QString& a, const QString& b)
+{
+    return a.size() != b.size() ? a.size() < b.size() : a < b;
+}
+
+QList<WordDifference> streamDiff(WordIterator &first, WordIterator &second, int limit, quint64 maxWords, bool *complete)
+{
+    PROFILE_SCOPE("streamDiff");
+    QList<WordDifference> result;
+    QString a, b;
+    bool hasA = first.next(a);
+    bool hasB = second.next(b);
+    auto withinBudget = [&]() {
+        return maxWords == 0 || std::max(first.produced(), second.produced()) <= maxWords;
+    };
+    while ((hasA || hasB) && result.size() < limit && withinBudget()) {
+        if (hasA && hasB && a == b) {
+            hasA = first.next(a);
+            hasB = second.next(b);
+        } else if (hasA && (!hasB || shortlexLess(a, b))) {
+            result.append({a, true});
+            hasA = first.next(a);
+        } else {
+            result.append({b, false});
+            hasB = second.next(b);
+        }
+    }
+    if (complete)
+        *complete = !hasA && !hasB;
+    return result;
+}
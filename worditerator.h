@@ -0,0 +1,55 @@
+#ifndef WORDITERATOR_H
+#define WORDITERATOR_H
+
+#include "chaincounter.h"
+
+#include <QList>
+#include <QString>
+
+// Ленивый перебор цепочек языка в порядке возрастания длины, внутри одной
+// длины — лексикографически. Хранится только текущая цепочка и таблицы
+// ChainCounter до её длины, поэтому остановиться можно на любом шаге, а
+// «первые 100 цепочек» стоят столько же, сколько их вычисление.
+//
+// Если maxLength < 0, перебор не ограничен длиной; для конечного языка он
+// всё равно завершается после самой длинной цепочки.
+class WordIterator
+{
+public:
+    explicit WordIterator(const Grammars::IndexedGrammar& grammar, int minLength = 0, int maxLength = -1);
+    explicit WordIterator(const Grammars::CFG& cfg, int minLength = 0, int maxLength = -1);
+    explicit WordIterator(const Grammars::Homskiy& homskiy, int minLength = 0, int maxLength = -1);
+
+    bool next(QString& word);
+    QStringList take(int count);
+    int length() const { return currentLength; }
+    quint64 produced() const { return count; }
+    // Длина самой длинной цепочки, -1 для бесконечного языка.
+    int longestWord() const { return longest; }
+
+private:
+    ChainCounter counter;
+    int maxLength;
+    int longest = -1;
+    int currentLength;
+    bool started = false;
+    QString current;
+    quint64 count = 0;
+
+    void computeLongest();
+    int lengthLimit() const;
+};
+
+// Сравнение двух потоков цепочек слиянием: возвращает не более limit цепочек,
+// которые есть только в одном из языков, в порядке перебора. При maxWords > 0
+// сравнение прекращается, когда один из потоков выдал maxWords цепочек;
+// complete сообщает, дошли ли оба потока до конца.
+struct WordDifference {
+    QString word;
+    bool inFirst;   // иначе только во втором
+};
+
+QList<WordDifference> streamDiff(WordIterator& first, WordIterator& second, int limit,
+                                 quint64 maxWords = 0, bool* complete = nullptr);
+
+#endif // WORDITERATOR_H